@@ -26,8 +26,15 @@
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include "ns3/log.h"
 
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
 #include "lora-channel.h"
 #include "lora-phy.h"
 #include "lora-prop-model.h"
@@ -36,6 +43,7 @@
 #include "lora-transducer.h"
 #include "lora-noise-model-default.h"
 #include "lora-prop-model-ideal.h"
+#include "lora-worker-pool.h"
 
 namespace ns3 {
 
@@ -58,8 +66,58 @@ LoraChannel::GetTypeId ()
     .AddAttribute ("NoiseModel",
                    "A pointer to the model of the channel ambient noise.",
                    StringValue ("ns3::LoraNoiseModelDefault"),
-                   MakePointerAccessor (&LoraChannel::m_noise),
+                   MakePointerAccessor (&LoraChannel::GetNoiseModel, &LoraChannel::SetNoiseModel),
                    MakePointerChecker<LoraNoiseModel> ())
+    .AddAttribute ("InterferenceFloor",
+                   "Received power (dB) under which a receiver is not "
+                   "delivered the signal at all.",
+                   DoubleValue (-1000.0),
+                   MakeDoubleAccessor (&LoraChannel::m_interferenceFloorDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SpatialIndexCellSize",
+                   "Side in meters of the cells of the grid used to find the "
+                   "receivers above the interference floor, 0 to disable.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&LoraChannel::m_gridCellSize),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("LinkBudgetCache",
+                   "Cache pathloss, PDP and delay between each pair of devices "
+                   "until one of them moves. Only valid with deterministic "
+                   "propagation models.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LoraChannel::m_cacheLinkBudget),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FanOutDispatch",
+                   "Deliver a transmission to all receivers through a single "
+                   "event walking the receivers by arrival time, instead of "
+                   "one event per receiver. Arrival times, order and node "
+                   "contexts are unchanged, but only the next arrival of each "
+                   "transmission is in the event queue.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LoraChannel::m_fanOutDispatch),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FrequencyFilter",
+                   "Only deliver a transmission to the devices whose PHY "
+                   "supports a mode overlapping its frequency band. Arrivals "
+                   "in other bands are then no longer seen as interference "
+                   "by the SINR models.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LoraChannel::m_frequencyFilter),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ParallelThreads",
+                   "Number of threads computing the link budgets of large "
+                   "transmissions, 1 to compute them on the simulator thread "
+                   "only. Requires a propagation model supporting positions, "
+                   "and is not used with the link budget cache.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&LoraChannel::m_parallelThreads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("ParallelThreshold",
+                   "Number of receivers from which the link budgets of a "
+                   "transmission are computed in parallel.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&LoraChannel::m_parallelThreshold),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
 
   return tid;
@@ -67,8 +125,18 @@ LoraChannel::GetTypeId ()
 
 LoraChannel::LoraChannel ()
   : Channel (),
+    m_listenersDirty (true),
+    m_frequencyFilter (false),
     m_prop (0),
-    m_cleared (false)
+    m_cleared (false),
+    m_parallelThreads (1),
+    m_parallelThreshold (1000),
+    m_fanOutDispatch (false),
+    m_cacheLinkBudget (false),
+    m_mobilityTracked (0),
+    m_interferenceFloorDb (-1000.0),
+    m_gridCellSize (0.0),
+    m_gridDirty (true)
 {
 }
 
@@ -84,6 +152,13 @@ LoraChannel::Clear ()
       return;
     }
   m_cleared = true;
+  // The mobility models may outlive the channel.
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator mob = m_mobilityIndex.begin ();
+  for (; mob != m_mobilityIndex.end (); mob++)
+    {
+      m_devRecords[mob->second.front ()].m_mobility->TraceDisconnectWithoutContext
+        ("CourseChange", MakeCallback (&LoraChannel::CourseChanged, this));
+    }
   LoraDeviceList::iterator it = m_devList.begin ();
   for (; it != m_devList.end (); it++)
     {
@@ -99,6 +174,18 @@ LoraChannel::Clear ()
         }
     }
   m_devList.clear ();
+  m_devRecords.clear ();
+  m_transIndex.clear ();
+  m_listeners.clear ();
+  m_bands.clear ();
+  m_grid.clear ();
+  m_gridPos.clear ();
+  m_gridDirty = true;
+  m_linkCache.clear ();
+  m_linkRefs.clear ();
+  m_mobilityIndex.clear ();
+  m_mobilityTracked = 0;
+  m_pool = 0;
   if (m_prop)
     {
       m_prop->Clear ();
@@ -141,72 +228,592 @@ void
 LoraChannel::AddDevice (Ptr<LoraNetDevice> dev, Ptr<LoraTransducer> trans)
 {
   NS_LOG_DEBUG ("Adding dev/trans pair number " << m_devList.size ());
+  DeviceRecord record;
+  record.m_index = m_devList.size ();
+  record.m_trans = trans;
+  m_transIndex.insert (std::make_pair (PeekPointer (trans), record.m_index));
+  m_devRecords.push_back (record);
   m_devList.push_back (std::make_pair (dev, trans));
+  m_listenersDirty = true;
+  m_gridDirty = true;
+}
+
+void
+LoraChannel::NotifyReceiveRoleChanged (void)
+{
+  m_listenersDirty = true;
+  m_gridDirty = true;
+}
+
+void
+LoraChannel::NotifySupportedModesChanged (void)
+{
+  m_bands.clear ();
+}
+
+void
+LoraChannel::BuildListeners (void)
+{
+  m_listeners.clear ();
+  for (uint32_t j = 0; j < m_devList.size (); j++)
+    {
+      if (m_devList[j].first->GetReceiveRole () != LoraNetDevice::RX_NEVER)
+        {
+          m_listeners.push_back (j);
+        }
+    }
+  NS_LOG_DEBUG (m_listeners.size () << " of " << m_devList.size () << " devices may listen");
+  m_listenersDirty = false;
+  m_bands.clear ();
+}
+
+const LoraChannel::BandSubscribers &
+LoraChannel::GetBandSubscribers (LoraTxMode txMode)
+{
+  if (m_listenersDirty)
+    {
+      BuildListeners ();
+    }
+  Band band (txMode.GetCenterFreqHz (), txMode.GetBandwidthHz ());
+  std::map<Band, BandSubscribers>::iterator found = m_bands.find (band);
+  if (found != m_bands.end ())
+    {
+      return found->second;
+    }
+
+  BandSubscribers &subscribers = m_bands[band];
+  subscribers.m_isMember.resize (m_devList.size (), false);
+  std::vector<uint32_t>::const_iterator it = m_listeners.begin ();
+  for (; it != m_listeners.end (); it++)
+    {
+      Ptr<LoraPhy> phy = m_devList[*it].first->GetPhy ();
+      uint32_t nModes = phy->GetNModes ();
+      for (uint32_t n = 0; n < nModes; n++)
+        {
+          LoraTxMode mode = phy->GetMode (n);
+          // Same overlap test as the SINR calculation
+          if (std::abs ((double) mode.GetCenterFreqHz () - (double) band.first)
+              < (double)(mode.GetBandwidthHz () / 2 + band.second / 2) - 0.5)
+            {
+              subscribers.m_devs.push_back (*it);
+              subscribers.m_isMember[*it] = true;
+              break;
+            }
+        }
+    }
+  NS_LOG_DEBUG (subscribers.m_devs.size () << " devices listen to " << band.first
+                                           << "Hz/" << band.second << "Hz");
+  return subscribers;
+}
+
+const LoraChannel::DeviceRecord &
+LoraChannel::GetRecord (uint32_t j)
+{
+  DeviceRecord &record = m_devRecords[j];
+  if (record.m_mobility == 0)
+    {
+      Ptr<Node> node = m_devList[j].first->GetNode ();
+      record.m_mobility = node->GetObject<MobilityModel> ();
+      record.m_nodeId = node->GetId ();
+    }
+  return record;
+}
+
+void
+LoraChannel::TrackMobility (void)
+{
+  for (uint32_t j = m_mobilityTracked; j < m_devList.size (); j++)
+    {
+      Ptr<MobilityModel> mobility = GetRecord (j).m_mobility;
+      NS_ASSERT (mobility != 0);
+      // Several devices of a node share its mobility model.
+      std::vector<uint32_t> &devs = m_mobilityIndex[PeekPointer (mobility)];
+      if (devs.empty ())
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange",
+                                                MakeCallback (&LoraChannel::CourseChanged, this));
+        }
+      devs.push_back (j);
+    }
+  m_mobilityTracked = m_devList.size ();
+}
+
+void
+LoraChannel::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  m_gridDirty = true;
+
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator found =
+    m_mobilityIndex.find (PeekPointer (mobility));
+  if (found == m_mobilityIndex.end ())
+    {
+      return;
+    }
+  std::vector<uint32_t>::const_iterator it = found->second.begin ();
+  for (; it != found->second.end (); it++)
+    {
+      DropLinkBudgets (*it);
+    }
+}
+
+uint64_t
+LoraChannel::MakeLinkKey (uint32_t freqHz, uint32_t j)
+{
+  return (static_cast<uint64_t> (freqHz) << 32) | j;
+}
+
+void
+LoraChannel::DropLinkBudgets (uint32_t j)
+{
+  if (j >= m_linkCache.size ())
+    {
+      return;
+    }
+  NS_LOG_DEBUG ("Device " << j << " moved, dropping its link budgets");
+
+  // Links from j: forget them in the references of their receivers.
+  LinkBudgetCache::const_iterator it = m_linkCache[j].begin ();
+  for (; it != m_linkCache[j].end (); it++)
+    {
+      uint32_t freqHz = static_cast<uint32_t> (it->first >> 32);
+      uint32_t rcvr = static_cast<uint32_t> (it->first);
+      m_linkRefs[rcvr].erase (MakeLinkKey (freqHz, j));
+    }
+  m_linkCache[j].clear ();
+
+  // Links to j, from the transmitters which reached it.
+  std::unordered_set<uint64_t>::const_iterator ref = m_linkRefs[j].begin ();
+  for (; ref != m_linkRefs[j].end (); ref++)
+    {
+      uint32_t freqHz = static_cast<uint32_t> (*ref >> 32);
+      uint32_t src = static_cast<uint32_t> (*ref);
+      m_linkCache[src].erase (MakeLinkKey (freqHz, j));
+    }
+  m_linkRefs[j].clear ();
+}
+
+const LoraChannel::LinkBudget &
+LoraChannel::GetLinkBudget (uint32_t srcIndex, uint32_t j,
+                            Ptr<MobilityModel> senderMobility,
+                            Ptr<MobilityModel> rcvrMobility,
+                            LoraTxMode txMode)
+{
+  if (m_linkCache.size () < m_devList.size ())
+    {
+      m_linkCache.resize (m_devList.size ());
+      m_linkRefs.resize (m_devList.size ());
+    }
+  uint32_t freqHz = txMode.GetCenterFreqHz ();
+  std::pair<LinkBudgetCache::iterator, bool> entry =
+    m_linkCache[srcIndex].insert (std::make_pair (MakeLinkKey (freqHz, j), LinkBudget ()));
+  LinkBudget &budget = entry.first->second;
+  if (entry.second)
+    {
+      budget.m_lossDb = m_prop->GetPathLossDb (senderMobility, rcvrMobility, txMode);
+      budget.m_delay = m_prop->GetDelay (senderMobility, rcvrMobility, txMode);
+      budget.m_pdp = m_prop->GetPdp (senderMobility, rcvrMobility, txMode);
+      m_linkRefs[j].insert (MakeLinkKey (freqHz, srcIndex));
+    }
+  return budget;
+}
+
+void
+LoraChannel::BuildGrid (void)
+{
+  if (m_listenersDirty)
+    {
+      BuildListeners ();
+    }
+  NS_LOG_DEBUG ("Building spatial grid of " << m_listeners.size () << " devices");
+  m_grid.clear ();
+  m_gridPos.resize (m_devList.size ());
+  std::vector<uint32_t>::const_iterator it = m_listeners.begin ();
+  for (; it != m_listeners.end (); it++)
+    {
+      uint32_t j = *it;
+      Ptr<MobilityModel> mobility = GetRecord (j).m_mobility;
+      NS_ASSERT (mobility != 0);
+      Vector pos = mobility->GetPosition ();
+      m_gridPos[j] = pos;
+      GridCell cell (static_cast<int32_t> (std::floor (pos.x / m_gridCellSize)),
+                     static_cast<int32_t> (std::floor (pos.y / m_gridCellSize)));
+      m_grid[cell].push_back (j);
+    }
+  m_gridDirty = false;
+}
+
+void
+LoraChannel::GetDevicesInRange (Vector pos, double range, std::vector<uint32_t> &found)
+{
+  found.clear ();
+  int32_t xMin = static_cast<int32_t> (std::floor ((pos.x - range) / m_gridCellSize));
+  int32_t xMax = static_cast<int32_t> (std::floor ((pos.x + range) / m_gridCellSize));
+  int32_t yMin = static_cast<int32_t> (std::floor ((pos.y - range) / m_gridCellSize));
+  int32_t yMax = static_cast<int32_t> (std::floor ((pos.y + range) / m_gridCellSize));
+
+  // Walk the populated cells directly when the search square covers more
+  // cells than there are populated ones.
+  double nCells = (double (xMax) - xMin + 1) * (double (yMax) - yMin + 1);
+  if (nCells > m_grid.size ())
+    {
+      Grid::const_iterator it = m_grid.begin ();
+      for (; it != m_grid.end (); it++)
+        {
+          if (it->first.first >= xMin && it->first.first <= xMax
+              && it->first.second >= yMin && it->first.second <= yMax)
+            {
+              found.insert (found.end (), it->second.begin (), it->second.end ());
+            }
+        }
+    }
+  else
+    {
+      for (int32_t x = xMin; x <= xMax; x++)
+        {
+          for (int32_t y = yMin; y <= yMax; y++)
+            {
+              Grid::const_iterator it = m_grid.find (GridCell (x, y));
+              if (it != m_grid.end ())
+                {
+                  found.insert (found.end (), it->second.begin (), it->second.end ());
+                }
+            }
+        }
+    }
+
+  std::vector<uint32_t>::iterator last = found.begin ();
+  for (std::vector<uint32_t>::iterator it = found.begin (); it != found.end (); it++)
+    {
+      if (CalculateDistance (pos, m_gridPos[*it]) <= range)
+        {
+          *last++ = *it;
+        }
+    }
+  found.erase (last, found.end ());
+  // Keep the scheduling order of a full scan.
+  std::sort (found.begin (), found.end ());
 }
 
 void
 LoraChannel::TxPacket (Ptr<LoraTransducer> src, Ptr<Packet> packet,
                       double txPowerDb, LoraTxMode txMode)
 {
-  Ptr<MobilityModel> senderMobility = 0;
-
   NS_LOG_DEBUG ("Channel scheduling");
-  for (LoraDeviceList::const_iterator i = m_devList.begin (); i
-       != m_devList.end (); i++)
+  std::unordered_map<const LoraTransducer *, uint32_t>::const_iterator found =
+    m_transIndex.find (PeekPointer (src));
+  NS_ASSERT (found != m_transIndex.end ());
+  uint32_t srcIndex = found->second;
+  Ptr<MobilityModel> senderMobility = GetRecord (srcIndex).m_mobility;
+  NS_ASSERT (senderMobility != 0);
+
+  if ((m_cacheLinkBudget || m_gridCellSize > 0) && m_mobilityTracked < m_devList.size ())
     {
+      TrackMobility ();
+    }
+
+  // A single copy, shielded from later changes by the sender, is shared
+  // by all the arrivals: only a receiver decoding it makes its own copy.
+  Ptr<Packet> shared = packet->Copy ();
+
+  Ptr<FanOut> fanOut = 0;
+  if (m_fanOutDispatch)
+    {
+      fanOut = Create<FanOut> ();
+      fanOut->m_txMode = txMode;
+      fanOut->m_packet = shared;
+    }
 
-      if (src == i->second)
+  m_candidates.clear ();
+  bool scanAll = true;
+  if (m_gridCellSize > 0)
+    {
+      double range = m_prop->GetMaxRangeM (txPowerDb - m_interferenceFloorDb, txMode);
+      if (range != std::numeric_limits<double>::infinity ())
         {
-          senderMobility = i->first->GetNode ()->GetObject<MobilityModel> ();
-          break;
+          if (m_gridDirty)
+            {
+              BuildGrid ();
+            }
+          std::vector<uint32_t> found;
+          GetDevicesInRange (senderMobility->GetPosition (), range, found);
+          NS_LOG_DEBUG ("Range " << range << "m, " << found.size () << " of "
+                                 << m_devList.size () << " devices in range");
+          const BandSubscribers *subscribers = 0;
+          if (m_frequencyFilter)
+            {
+              subscribers = &GetBandSubscribers (txMode);
+            }
+          std::vector<uint32_t>::const_iterator it = found.begin ();
+          for (; it != found.end (); it++)
+            {
+              if (*it != srcIndex
+                  && (subscribers == 0 || subscribers->m_isMember[*it]))
+                {
+                  m_candidates.push_back (*it);
+                }
+            }
+          scanAll = false;
         }
     }
-  NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  LoraDeviceList::const_iterator i = m_devList.begin ();
-  for (; i != m_devList.end (); i++)
+
+  if (scanAll)
+    {
+      if (m_listenersDirty)
+        {
+          BuildListeners ();
+        }
+      const std::vector<uint32_t> &listeners =
+        m_frequencyFilter ? GetBandSubscribers (txMode).m_devs : m_listeners;
+      std::vector<uint32_t>::const_iterator it = listeners.begin ();
+      for (; it != listeners.end (); it++)
+        {
+          if (*it != srcIndex)
+            {
+              m_candidates.push_back (*it);
+            }
+        }
+    }
+
+  if (m_parallelThreads > 1 && m_candidates.size () >= m_parallelThreshold
+      && !m_cacheLinkBudget && m_prop->SupportsPositions ())
+    {
+      ScheduleRxBatch (senderMobility, shared, txPowerDb, txMode, fanOut);
+    }
+  else
+    {
+      std::vector<uint32_t>::const_iterator it = m_candidates.begin ();
+      for (; it != m_candidates.end (); it++)
+        {
+          ScheduleRx (srcIndex, *it, senderMobility, shared, txPowerDb, txMode, fanOut);
+        }
+    }
+
+  if (fanOut && !fanOut->m_rx.empty ())
+    {
+      // Stable, so that simultaneous arrivals keep the device order.
+      std::stable_sort (fanOut->m_rx.begin (), fanOut->m_rx.end (), &LoraChannel::ArrivesBefore);
+      Simulator::ScheduleWithContext (fanOut->m_rx[0].m_nodeId,
+                                      fanOut->m_rx[0].m_arrival - Simulator::Now (),
+                                      &LoraChannel::DispatchFanOut, this, fanOut);
+    }
+}
+
+bool
+LoraChannel::ArrivesBefore (const PendingRx &a, const PendingRx &b)
+{
+  return a.m_arrival < b.m_arrival;
+}
+
+void
+LoraChannel::DispatchFanOut (Ptr<FanOut> fanOut)
+{
+  Time now = Simulator::Now ();
+  uint32_t context = Simulator::GetContext ();
+  // Simultaneous arrivals at other nodes get their own event, so that
+  // each delivery runs in the context of its receiver.
+  while (fanOut->m_next < fanOut->m_rx.size ()
+         && fanOut->m_rx[fanOut->m_next].m_arrival <= now
+         && fanOut->m_rx[fanOut->m_next].m_nodeId == context)
+    {
+      PendingRx &rx = fanOut->m_rx[fanOut->m_next++];
+      SendUp (rx.m_dev, fanOut->m_packet, rx.m_rxPowerDb, fanOut->m_txMode, rx.m_pdp);
+    }
+  if (fanOut->m_next < fanOut->m_rx.size ())
     {
-      if (src != i->second)
+      const PendingRx &next = fanOut->m_rx[fanOut->m_next];
+      Simulator::ScheduleWithContext (next.m_nodeId, next.m_arrival - now,
+                                      &LoraChannel::DispatchFanOut, this, fanOut);
+    }
+}
+
+void
+LoraChannel::ScheduleRx (uint32_t srcIndex, uint32_t j, Ptr<MobilityModel> senderMobility,
+                         Ptr<Packet> packet, double txPowerDb, LoraTxMode txMode,
+                         Ptr<FanOut> fanOut)
+{
+  const DeviceRecord &rcvr = GetRecord (j);
+  NS_LOG_DEBUG ("Scheduling " << m_devList[j].first->GetMac ()->GetAddress ());
+  Ptr<MobilityModel> rcvrMobility = rcvr.m_mobility;
+  double rxPowerDb;
+  Time delay;
+  LoraPdp pdp;
+  if (m_cacheLinkBudget)
+    {
+      const LinkBudget &budget = GetLinkBudget (srcIndex, j, senderMobility,
+                                                rcvrMobility, txMode);
+      rxPowerDb = txPowerDb - budget.m_lossDb;
+      delay = budget.m_delay;
+      pdp = budget.m_pdp;
+    }
+  else
+    {
+      rxPowerDb = txPowerDb - m_prop->GetPathLossDb (senderMobility,
+                                                     rcvrMobility,
+                                                     txMode);
+      delay = m_prop->GetDelay (senderMobility, rcvrMobility, txMode);
+      pdp = m_prop->GetPdp (senderMobility, rcvrMobility, txMode);
+    }
+
+  NS_LOG_DEBUG ("txPowerDb=" << txPowerDb << "dB, rxPowerDb="
+                             << rxPowerDb << "dB, distance="
+                             << senderMobility->GetDistanceFrom (rcvrMobility)
+                             << "m, delay=" << delay);
+  DeliverRx (j, packet, rxPowerDb, delay, pdp, txMode, fanOut);
+}
+
+/**
+ * Link budgets from one transmitter to arrays of receiver positions,
+ * run by the worker pool of the channel.
+ */
+class LoraLinkBudgetJob : public LoraWorkerPool::Job
+{
+public:
+  /**
+   * \param prop The propagation model, which supports positions.
+   * \param sender Position of the transmitter.
+   * \param mode Mode of the transmission.
+   * \param x X coordinates of the receivers.
+   * \param y Y coordinates of the receivers.
+   * \param z Z coordinates of the receivers.
+   * \param lossDb Pathloss to each receiver, in dB, filled by the job.
+   * \param delayS Delay to each receiver, in seconds, filled by the job.
+   */
+  LoraLinkBudgetJob (LoraPropModel *prop, Vector sender, LoraTxMode mode,
+                     const double *x, const double *y, const double *z,
+                     double *lossDb, double *delayS)
+    : m_prop (prop),
+      m_sender (sender),
+      m_mode (mode),
+      m_x (x),
+      m_y (y),
+      m_z (z),
+      m_lossDb (lossDb),
+      m_delayS (delayS)
+  {
+  }
+  virtual void Execute (uint32_t begin, uint32_t end)
+  {
+    m_prop->GetLinkBudgetsFromPositions (m_sender, m_x + begin, m_y + begin, m_z + begin,
+                                         end - begin, m_mode,
+                                         m_lossDb + begin, m_delayS + begin);
+  }
+private:
+  LoraPropModel *m_prop;   //!< The propagation model, not a Ptr to keep threads off its reference count.
+  Vector m_sender;         //!< Position of the transmitter.
+  LoraTxMode m_mode;       //!< Mode of the transmission.
+  const double *m_x;       //!< X coordinates of the receivers.
+  const double *m_y;       //!< Y coordinates of the receivers.
+  const double *m_z;       //!< Z coordinates of the receivers.
+  double *m_lossDb;        //!< Pathloss to each receiver.
+  double *m_delayS;        //!< Delay to each receiver.
+};
+
+void
+LoraChannel::ScheduleRxBatch (Ptr<MobilityModel> senderMobility, Ptr<Packet> packet,
+                              double txPowerDb, LoraTxMode txMode, Ptr<FanOut> fanOut)
+{
+  uint32_t n = m_candidates.size ();
+
+  // Everything touching the simulator or the mobility models stays on
+  // this thread, only the propagation model may run on the workers.
+  m_rcvrX.resize (n);
+  m_rcvrY.resize (n);
+  m_rcvrZ.resize (n);
+  m_rcvrLossDb.resize (n);
+  m_rcvrDelayS.resize (n);
+  for (uint32_t k = 0; k < n; k++)
+    {
+      Vector pos = GetRecord (m_candidates[k]).m_mobility->GetPosition ();
+      m_rcvrX[k] = pos.x;
+      m_rcvrY[k] = pos.y;
+      m_rcvrZ[k] = pos.z;
+    }
+  LoraLinkBudgetJob job (PeekPointer (m_prop), senderMobility->GetPosition (), txMode,
+                         &m_rcvrX[0], &m_rcvrY[0], &m_rcvrZ[0],
+                         &m_rcvrLossDb[0], &m_rcvrDelayS[0]);
+  if (m_pool == 0 || m_pool->GetNThreads () != m_parallelThreads)
+    {
+      m_pool = Create<LoraWorkerPool> (m_parallelThreads);
+    }
+  m_pool->Run (n, &job);
+  NS_LOG_DEBUG ("Computed " << n << " link budgets on " << m_pool->GetNThreads () << " threads");
+
+  // Schedule in candidate order, as the per receiver path does.
+  for (uint32_t k = 0; k < n; k++)
+    {
+      uint32_t j = m_candidates[k];
+      double rxPowerDb = txPowerDb - m_rcvrLossDb[k];
+      if (rxPowerDb < m_interferenceFloorDb)
         {
-          NS_LOG_DEBUG ("Scheduling " << i->first->GetMac ()->GetAddress ());
-          Ptr<MobilityModel> rcvrMobility = i->first->GetNode ()->GetObject<MobilityModel> ();
-          Time delay = m_prop->GetDelay (senderMobility, rcvrMobility, txMode);
-          LoraPdp pdp = m_prop->GetPdp (senderMobility, rcvrMobility, txMode);
-          double rxPowerDb = txPowerDb - m_prop->GetPathLossDb (senderMobility,
-                                                                rcvrMobility,
-                                                                txMode);
-
-          NS_LOG_DEBUG ("txPowerDb=" << txPowerDb << "dB, rxPowerDb="
-                                     << rxPowerDb << "dB, distance="
-                                     << senderMobility->GetDistanceFrom (rcvrMobility)
-                                     << "m, delay=" << delay);
-
-          uint32_t dstNodeId = i->first->GetNode ()->GetId ();
-          Ptr<Packet> copy = packet->Copy ();
-          Simulator::ScheduleWithContext (dstNodeId, delay,
-                                          &LoraChannel::SendUp,
-                                          this,
-                                          j,
-                                          copy,
-                                          rxPowerDb,
-                                          txMode,
-                                          pdp);
+          NS_LOG_DEBUG ("rxPowerDb=" << rxPowerDb << "dB under the interference floor, dropped");
+          continue;
         }
-      j++;
+      LoraPdp pdp = m_prop->GetPdp (senderMobility, GetRecord (j).m_mobility, txMode);
+      DeliverRx (j, packet, rxPowerDb, Seconds (m_rcvrDelayS[k]), pdp, txMode, fanOut);
     }
 }
 
+void
+LoraChannel::DeliverRx (uint32_t j, Ptr<Packet> packet, double rxPowerDb, Time delay,
+                        LoraPdp pdp, LoraTxMode txMode, Ptr<FanOut> fanOut)
+{
+  if (rxPowerDb < m_interferenceFloorDb)
+    {
+      NS_LOG_DEBUG ("rxPowerDb=" << rxPowerDb << "dB under the interference floor, dropped");
+      return;
+    }
+
+  if (fanOut)
+    {
+      PendingRx rx;
+      rx.m_arrival = Simulator::Now () + delay;
+      rx.m_dev = j;
+      rx.m_nodeId = GetRecord (j).m_nodeId;
+      rx.m_rxPowerDb = rxPowerDb;
+      rx.m_pdp = pdp;
+      fanOut->m_rx.push_back (rx);
+      return;
+    }
+
+  Simulator::ScheduleWithContext (GetRecord (j).m_nodeId, delay,
+                                  &LoraChannel::SendUp,
+                                  this,
+                                  j,
+                                  packet,
+                                  rxPowerDb,
+                                  txMode,
+                                  pdp);
+}
+
 void
 LoraChannel::SetNoiseModel (Ptr<LoraNoiseModel> noise)
 {
   NS_ASSERT (noise);
   m_noise = noise;
+  // The transducers cache the noise of each mode.
+  LoraDeviceList::const_iterator it = m_devList.begin ();
+  for (; it != m_devList.end (); it++)
+    {
+      it->second->ResetNoiseCache ();
+    }
+}
+
+Ptr<LoraNoiseModel>
+LoraChannel::GetNoiseModel (void) const
+{
+  return m_noise;
 }
 void
 LoraChannel::SendUp (uint32_t i, Ptr<Packet> packet, double rxPowerDb,
                     LoraTxMode txMode, LoraPdp pdp)
 {
   NS_LOG_DEBUG ("Channel:  In sendup");
+  if (m_devList[i].first->GetReceiveRole () == LoraNetDevice::RX_WHEN_AWAKE
+      && m_devList[i].first->GetPhy ()->IsStateSleep ())
+    {
+      NS_LOG_DEBUG ("Device " << i << " is sleeping, not listening");
+      return;
+    }
   m_devList[i].second->Receive (packet, rxPowerDb, txMode, pdp);
 }
 
@@ -25,19 +25,26 @@
 #include "ns3/packet.h"
 #include "ns3/lora-prop-model.h"
 #include "ns3/lora-noise-model.h"
+#include "ns3/lora-tx-mode.h"
 #include "ns3/nstime.h"
 #include "ns3/data-rate.h"
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
+#include "ns3/simple-ref-count.h"
 
 #include <list>
 #include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace ns3 {
 
+class MobilityModel;
+class LoraWorkerPool;
 class LoraNetDevice;
 class LoraPhy;
 class LoraTransducer;
-class LoraTxMode;
 
 
 /**
@@ -81,6 +88,8 @@ public:
   /**
    * Send a packet out on the channel.
    *
+   * All the receivers are handed the same read-only copy of the packet.
+   *
    * \param src Transducer transmitting packet.
    * \param packet Packet to be transmitted.
    * \param txPowerDb Transmission power in dB.
@@ -113,6 +122,13 @@ public:
    */
   void SetNoiseModel  (Ptr<LoraNoiseModel> noise);
 
+  /**
+   * Get the noise model of this channel.
+   *
+   * \return The noise model.
+   */
+  Ptr<LoraNoiseModel> GetNoiseModel (void) const;
+
   /**
    * Get the noise level on the channel.
    *
@@ -121,6 +137,18 @@ public:
    */
   double GetNoiseDbHz (double fKhz);
 
+  /**
+   * Notify the channel that the receive role of one
+   * of its devices changed.
+   */
+  void NotifyReceiveRoleChanged (void);
+
+  /**
+   * Notify the channel that the supported modes of the PHY
+   * of one of its devices changed.
+   */
+  void NotifySupportedModesChanged (void);
+
   /**
    * Clear all pointer references. */
   void Clear (void);
@@ -213,7 +241,63 @@ public:
 
 
 private:
+  /**
+   * Per device data needed on every transmission, resolved once.
+   */
+  struct DeviceRecord
+  {
+    DeviceRecord () : m_index (0), m_nodeId (0) {}
+    uint32_t m_index;                //!< Device number on this channel.
+    Ptr<LoraTransducer> m_trans;     //!< Transducer of the device.
+    Ptr<MobilityModel> m_mobility;   //!< Mobility model of the node, 0 until resolved.
+    uint32_t m_nodeId;               //!< Id of the node.
+  };
+
+  /**
+   * Get the record of a device, resolving its node and mobility
+   * model on first use since they may not be set at AddDevice time.
+   *
+   * \param j Device number.
+   * \return The device record.
+   */
+  const DeviceRecord &GetRecord (uint32_t j);
+
   LoraDeviceList m_devList;     //!< The list of devices on this channel.
+  std::vector<DeviceRecord> m_devRecords;  //!< Records, indexed by device number.
+  /** Device number of each transducer. */
+  std::unordered_map<const LoraTransducer *, uint32_t> m_transIndex;
+
+  /** Rebuild the list of devices which may listen to the channel. */
+  void BuildListeners (void);
+
+  /** Device numbers of the devices which may listen, in increasing order. */
+  std::vector<uint32_t> m_listeners;
+  bool m_listenersDirty;        //!< The listener list must be rebuilt before use.
+
+  /** A frequency band: center frequency and bandwidth in Hz. */
+  typedef std::pair<uint32_t, uint32_t> Band;
+  /**
+   * Devices with a PHY mode overlapping a band.
+   */
+  struct BandSubscribers
+  {
+    std::vector<uint32_t> m_devs;   //!< Device numbers, in increasing order.
+    std::vector<bool> m_isMember;   //!< Membership, indexed by device number.
+  };
+
+  /**
+   * Get the devices which may listen and support a mode overlapping
+   * the band of a transmission mode, building the list on first use.
+   *
+   * \param txMode Mode of the transmission.
+   * \return The subscribers of the band.
+   */
+  const BandSubscribers &GetBandSubscribers (LoraTxMode txMode);
+
+  /** Only deliver to devices having a mode overlapping the transmission. */
+  bool m_frequencyFilter;
+  /** Subscribers of each band used so far. */
+  std::map<Band, BandSubscribers> m_bands;
   Ptr<LoraPropModel> m_prop;    //!< The propagation model.
   Ptr<LoraNoiseModel> m_noise;  //!< The noise model.
   /** Has Clear ever been called on the channel. */
@@ -230,6 +314,218 @@ private:
    */
   void SendUp (uint32_t i, Ptr<Packet> packet, double rxPowerDb, LoraTxMode txMode, LoraPdp pdp);
 
+  /**
+   * Arrival of a transmission at one receiver, waiting for dispatch.
+   */
+  struct PendingRx
+  {
+    Time m_arrival;        //!< Absolute arrival time.
+    uint32_t m_dev;        //!< Device number of the receiver.
+    uint32_t m_nodeId;     //!< Node of the receiver, context of the delivery.
+    double m_rxPowerDb;    //!< Received power in dB.
+    LoraPdp m_pdp;         //!< Power delay profile of the link.
+  };
+
+  /**
+   * All the arrivals of one transmission, sorted by arrival time,
+   * delivered by a single self-rescheduling event which runs in the
+   * context of the receiver node of the next arrival.
+   */
+  class FanOut : public SimpleRefCount<FanOut>
+  {
+  public:
+    FanOut () : m_next (0) {}
+    std::vector<PendingRx> m_rx;  //!< Arrivals, in dispatch order.
+    Ptr<Packet> m_packet;         //!< Packet shared by all the arrivals.
+    LoraTxMode m_txMode;          //!< Mode of the transmission.
+    uint32_t m_next;              //!< Index of the next arrival to deliver.
+  };
+
+  /**
+   * Order arrivals by arrival time.
+   *
+   * \param a First arrival.
+   * \param b Second arrival.
+   * \return True if a arrives before b.
+   */
+  static bool ArrivesBefore (const PendingRx &a, const PendingRx &b);
+
+  /**
+   * Deliver the arrivals of a fan-out due now at the node of the
+   * current context, and reschedule in the context of the next one.
+   *
+   * \param fanOut The pending arrivals of a transmission.
+   */
+  void DispatchFanOut (Ptr<FanOut> fanOut);
+
+  /**
+   * Compute the link budget to one receiver and schedule the arrival,
+   * unless the received power falls below the interference floor.
+   *
+   * \param srcIndex Device number of the transmitter.
+   * \param j Device number of the receiver.
+   * \param senderMobility Mobility model of the transmitter.
+   * \param packet Packet to be transmitted, shared by all receivers.
+   * \param txPowerDb Transmission power in dB.
+   * \param txMode Mode of the transmission.
+   * \param fanOut If not null, the arrival is queued there instead of
+   *   being scheduled as its own event.
+   */
+  void ScheduleRx (uint32_t srcIndex, uint32_t j, Ptr<MobilityModel> senderMobility,
+                   Ptr<Packet> packet, double txPowerDb, LoraTxMode txMode,
+                   Ptr<FanOut> fanOut);
+
+  /**
+   * Compute the link budgets to all the candidate receivers on the
+   * worker pool, then schedule the arrivals in candidate order.
+   *
+   * \param senderMobility Mobility model of the transmitter.
+   * \param packet Packet to be transmitted, shared by all receivers.
+   * \param txPowerDb Transmission power in dB.
+   * \param txMode Mode of the transmission.
+   * \param fanOut If not null, the arrivals are queued there.
+   */
+  void ScheduleRxBatch (Ptr<MobilityModel> senderMobility, Ptr<Packet> packet,
+                        double txPowerDb, LoraTxMode txMode, Ptr<FanOut> fanOut);
+
+  /**
+   * Schedule an arrival, unless the received power falls below
+   * the interference floor.
+   *
+   * \param j Device number of the receiver.
+   * \param packet Packet to be transmitted, shared by all receivers.
+   * \param rxPowerDb Received power in dB.
+   * \param delay Propagation delay.
+   * \param pdp Power delay profile of the link.
+   * \param txMode Mode of the transmission.
+   * \param fanOut If not null, the arrival is queued there.
+   */
+  void DeliverRx (uint32_t j, Ptr<Packet> packet, double rxPowerDb, Time delay,
+                  LoraPdp pdp, LoraTxMode txMode, Ptr<FanOut> fanOut);
+
+  std::vector<uint32_t> m_candidates;  //!< Receivers of the current transmission.
+  uint32_t m_parallelThreads;          //!< Threads computing link budgets.
+  uint32_t m_parallelThreshold;        //!< Receivers from which to use the threads.
+  Ptr<LoraWorkerPool> m_pool;          //!< The worker threads, created on first use.
+  std::vector<double> m_rcvrX;         //!< Receiver X coordinates of the current batch.
+  std::vector<double> m_rcvrY;         //!< Receiver Y coordinates of the current batch.
+  std::vector<double> m_rcvrZ;         //!< Receiver Z coordinates of the current batch.
+  std::vector<double> m_rcvrLossDb;    //!< Pathlosses of the current batch.
+  std::vector<double> m_rcvrDelayS;    //!< Delays of the current batch.
+
+  /**
+   * Deliver each transmission through a single event, rather than one
+   * event per receiver.
+   */
+  bool m_fanOutDispatch;
+
+  /**
+   * Hook the CourseChange trace of the devices not traced so far.
+   */
+  void TrackMobility (void);
+
+  /**
+   * (Re)build the spatial grid from the current positions of the
+   * devices which may listen.
+   */
+  void BuildGrid (void);
+
+  /**
+   * Collect the devices lying within a range of a position, in
+   * increasing device number order.
+   *
+   * \param pos Center of the search.
+   * \param range Search radius in meters.
+   * \param found Device numbers found, cleared first.
+   */
+  void GetDevicesInRange (Vector pos, double range, std::vector<uint32_t> &found);
+
+  /**
+   * Invalidate the spatial grid and the cached link budgets
+   * of a device when it moves.
+   *
+   * \param mobility The mobility model whose course changed.
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+
+  /**
+   * Link budget between a transmitter and a receiver,
+   * which only depends on their positions and the center frequency.
+   */
+  struct LinkBudget
+  {
+    LinkBudget () : m_lossDb (0) {}
+    double m_lossDb;   //!< Pathloss in dB.
+    Time m_delay;      //!< Propagation delay.
+    LoraPdp m_pdp;     //!< Power delay profile.
+  };
+  /**
+   * Link budgets from one transmitter, keyed by center frequency and
+   * receiver device number, holding only the receivers reached so far.
+   */
+  typedef std::unordered_map<uint64_t, LinkBudget> LinkBudgetCache;
+
+  /**
+   * Build a link budget cache key.
+   *
+   * \param freqHz Center frequency in Hz.
+   * \param j Device number of the other end of the link.
+   * \return The key.
+   */
+  static uint64_t MakeLinkKey (uint32_t freqHz, uint32_t j);
+
+  /**
+   * Drop the cached link budgets from and to a device.
+   *
+   * \param j Device number.
+   */
+  void DropLinkBudgets (uint32_t j);
+
+  /**
+   * Get the link budget from a transmitter to a receiver, computing
+   * it through the propagation model on a cache miss.
+   *
+   * \param srcIndex Device number of the transmitter.
+   * \param j Device number of the receiver.
+   * \param senderMobility Mobility model of the transmitter.
+   * \param rcvrMobility Mobility model of the receiver.
+   * \param txMode Mode of the transmission.
+   * \return The link budget.
+   */
+  const LinkBudget &GetLinkBudget (uint32_t srcIndex, uint32_t j,
+                                   Ptr<MobilityModel> senderMobility,
+                                   Ptr<MobilityModel> rcvrMobility,
+                                   LoraTxMode txMode);
+
+  /** Cache pathloss, PDP and delay between devices until one of them moves. */
+  bool m_cacheLinkBudget;
+  /** Link budget caches, indexed by transmitter device number. */
+  std::vector<LinkBudgetCache> m_linkCache;
+  /**
+   * Keys (center frequency, transmitter) of the cached link budgets
+   * towards each device, indexed by receiver device number.
+   */
+  std::vector<std::unordered_set<uint64_t> > m_linkRefs;
+  /** Device numbers of the devices sharing each traced mobility model. */
+  std::map<const MobilityModel *, std::vector<uint32_t> > m_mobilityIndex;
+  uint32_t m_mobilityTracked;     //!< Number of devices whose moves are traced.
+
+  /** Grid cell coordinates (x, y). */
+  typedef std::pair<int32_t, int32_t> GridCell;
+  /** Uniform grid over the device positions, only populated cells are stored. */
+  typedef std::map<GridCell, std::vector<uint32_t> > Grid;
+
+  /**
+   * Receivers whose received power in dB falls below this floor
+   * do not get the signal at all.
+   */
+  double m_interferenceFloorDb;
+  /** Side of a spatial grid cell in meters, 0 disables the grid. */
+  double m_gridCellSize;
+  Grid m_grid;                    //!< The spatial grid.
+  std::vector<Vector> m_gridPos;  //!< Device positions at the last grid build.
+  bool m_gridDirty;               //!< The grid must be rebuilt before use.
+
 
 
   /**
@@ -23,6 +23,7 @@
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (LoraHeaderCommon);
+NS_OBJECT_ENSURE_REGISTERED (LoraFrameCounterTag);
 
 LoraHeaderCommon::LoraHeaderCommon ()
 {
@@ -141,4 +142,69 @@ LoraHeaderCommon::Print (std::ostream &os) const
 
 
 
+LoraFrameCounterTag::LoraFrameCounterTag ()
+  : Tag (),
+    m_frameCounter (0)
+{
+}
+
+LoraFrameCounterTag::LoraFrameCounterTag (uint16_t frameCounter)
+  : Tag (),
+    m_frameCounter (frameCounter)
+{
+}
+
+TypeId
+LoraFrameCounterTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LoraFrameCounterTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Lora")
+    .AddConstructor<LoraFrameCounterTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+LoraFrameCounterTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+LoraFrameCounterTag::SetFrameCounter (uint16_t frameCounter)
+{
+  m_frameCounter = frameCounter;
+}
+
+uint16_t
+LoraFrameCounterTag::GetFrameCounter (void) const
+{
+  return m_frameCounter;
+}
+
+uint32_t
+LoraFrameCounterTag::GetSerializedSize (void) const
+{
+  return 2;
+}
+
+void
+LoraFrameCounterTag::Serialize (TagBuffer i) const
+{
+  i.WriteU16 (m_frameCounter);
+}
+
+void
+LoraFrameCounterTag::Deserialize (TagBuffer i)
+{
+  m_frameCounter = i.ReadU16 ();
+}
+
+void
+LoraFrameCounterTag::Print (std::ostream &os) const
+{
+  os << "FCnt=" << m_frameCounter;
+}
+
 } // namespace ns3
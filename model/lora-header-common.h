@@ -21,6 +21,7 @@
 #define LORA_HEADER_COMMON_H
 
 #include "ns3/header.h"
+#include "ns3/tag.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
 #include "lora-address.h"
@@ -132,6 +133,57 @@ private:
 
 };  // class LoraHeaderCommon
 
+/**
+ * Frame counter of an uplink, set by the sending MAC.
+ *
+ * Carried as a packet tag rather than a header field so that it does
+ * not change the frame size, hence the time on air, of existing
+ * scenarios.  Together with the source address it identifies the
+ * copies of one uplink received by several gateways.
+ */
+class LoraFrameCounterTag : public Tag
+{
+public:
+  /** Default constructor */
+  LoraFrameCounterTag ();
+  /**
+   * Constructor.
+   *
+   * \param frameCounter The frame counter.
+   */
+  LoraFrameCounterTag (uint16_t frameCounter);
+
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * Set the frame counter.
+   *
+   * \param frameCounter The frame counter.
+   */
+  void SetFrameCounter (uint16_t frameCounter);
+  /**
+   * Get the frame counter.
+   *
+   * \return The frame counter.
+   */
+  uint16_t GetFrameCounter (void) const;
+
+  // Inherited methods
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+private:
+  uint16_t m_frameCounter;  //!< The frame counter.
+
+};  // class LoraFrameCounterTag
+
 } // namespace ns3
 
 #endif /* LORA_HEADER_COMMON_H */
@@ -47,6 +47,7 @@ NS_OBJECT_ENSURE_REGISTERED (LoraNetDevice);
 
 LoraNetDevice::LoraNetDevice ()
   : NetDevice (),
+    m_rxRole (RX_ALWAYS),
     m_mtu (64000),
     m_cleared (false)
 {
@@ -117,6 +118,14 @@ LoraNetDevice::GetTypeId ()
                    MakePointerAccessor (&LoraNetDevice::GetTransducer,
                                         &LoraNetDevice::SetTransducer),
                    MakePointerChecker<LoraTransducer> ())
+    .AddAttribute ("ReceiveRole",
+                   "When the device listens to the transmissions of the channel.",
+                   EnumValue (RX_ALWAYS),
+                   MakeEnumAccessor (&LoraNetDevice::SetReceiveRole,
+                                     &LoraNetDevice::GetReceiveRole),
+                   MakeEnumChecker (RX_ALWAYS, "Always",
+                                    RX_WHEN_AWAKE, "WhenAwake",
+                                    RX_NEVER, "Never"))
     .AddTraceSource ("Rx", "Received payload from the MAC layer.",
                      MakeTraceSourceAccessor (&LoraNetDevice::m_rxLogger),
                      "ns3::LoraNetDevice::RxTxTracedCallback")
@@ -165,7 +174,11 @@ LoraNetDevice::SetPhy (Ptr<LoraPhy> phy)
           m_phy->SetTransducer (m_trans);
           NS_LOG_DEBUG ("Added PHY to trans");
         }
-
+      if (m_channel != 0)
+        {
+          // The new PHY may listen to other bands.
+          m_channel->NotifySupportedModesChanged ();
+        }
     }
 }
 
@@ -441,6 +454,22 @@ LoraNetDevice::SetSleepMode (bool sleep)
   m_phy->SetSleepMode (sleep);
 }
 
+void
+LoraNetDevice::SetReceiveRole (ReceiveRole role)
+{
+  m_rxRole = role;
+  if (m_channel != 0)
+    {
+      m_channel->NotifyReceiveRoleChanged ();
+    }
+}
+
+LoraNetDevice::ReceiveRole
+LoraNetDevice::GetReceiveRole (void) const
+{
+  return m_rxRole;
+}
+
 
 void
 LoraNetDevice::TransmitStart (void)
@@ -57,6 +57,16 @@ public:
   /** List of LoraTransducer objects. */
   typedef std::list<Ptr<LoraTransducer> > LoraTransducerList;
 
+  /**
+   * When the device listens to the transmissions of the channel.
+   */
+  enum ReceiveRole
+  {
+    RX_ALWAYS,      //!< Always listening, as a gateway.
+    RX_WHEN_AWAKE,  //!< Listening while the PHY is not in SLEEP.
+    RX_NEVER        //!< Never listening, the channel skips the device.
+  };
+
   /**
    * Register this type.
    * \return The TypeId.
@@ -126,6 +136,19 @@ public:
    */
   void SetSleepMode (bool sleep);
 
+  /**
+   * Set when the device listens to the channel.
+   *
+   * \param role The receive role.
+   */
+  void SetReceiveRole (ReceiveRole role);
+  /**
+   * Get when the device listens to the channel.
+   *
+   * \return The receive role.
+   */
+  ReceiveRole GetReceiveRole (void) const;
+
 
   void SetChannelMode (uint32_t mode);
   uint32_t GetChannelMode (void);
@@ -191,6 +214,7 @@ private:
   Ptr<LoraChannel> m_channel;       //!< The channel attached to this device.
   Ptr<LoraMac> m_mac;               //!< The MAC layer attached to this device.
   Ptr<LoraPhy> m_phy;               //!< The PHY layer attached to this device.
+  ReceiveRole m_rxRole;             //!< When the device listens to the channel.
 
   LoraTxMode m_txMode;
 
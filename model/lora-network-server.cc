@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lora-network-server.h"
+#include "lora-net-device.h"
+#include "lora-header-common.h"
+#include "mac-lora-gw.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LoraNetworkServer");
+
+NS_OBJECT_ENSURE_REGISTERED (LoraNetworkServer);
+
+LoraNetworkServer::LoraNetworkServer ()
+  : Object ()
+{
+}
+
+LoraNetworkServer::~LoraNetworkServer ()
+{
+}
+
+void
+LoraNetworkServer::DoDispose ()
+{
+  std::vector<Ptr<LoraNetDevice> >::const_iterator it = m_gateways.begin ();
+  for (; it != m_gateways.end (); it++)
+    {
+      Ptr<MacLoraAca> mac = DynamicCast<MacLoraAca> ((*it)->GetMac ());
+      if (mac)
+        {
+          mac->SetUplinkCallback (MakeNullCallback<void, Ptr<Packet>, const LoraAddress&, double, const LoraAddress& > ());
+        }
+    }
+  m_gateways.clear ();
+  m_gwIndex.clear ();
+  m_uplinks.clear ();
+  m_expiry.clear ();
+  m_devices.clear ();
+  m_recvCb = MakeNullCallback<void, Ptr<Packet>, const LoraAddress& > ();
+  Object::DoDispose ();
+}
+
+TypeId
+LoraNetworkServer::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LoraNetworkServer")
+    .SetParent<Object> ()
+    .SetGroupName ("Lora")
+    .AddConstructor<LoraNetworkServer> ()
+    .AddAttribute ("DedupWindow",
+                   "Time after the first copy of an uplink during which other copies "
+                   "with the same source and frame counter are duplicates.",
+                   TimeValue (MilliSeconds (200)),
+                   MakeTimeAccessor (&LoraNetworkServer::m_window),
+                   MakeTimeChecker ())
+    .AddTraceSource ("Uplink",
+                     "A new uplink was received and delivered.",
+                     MakeTraceSourceAccessor (&LoraNetworkServer::m_uplinkTrace),
+                     "ns3::LoraNetworkServer::UplinkTracedCallback")
+    .AddTraceSource ("Duplicate",
+                     "A duplicate copy of an uplink was received.",
+                     MakeTraceSourceAccessor (&LoraNetworkServer::m_duplicateTrace),
+                     "ns3::LoraNetworkServer::UplinkTracedCallback")
+  ;
+  return tid;
+}
+
+void
+LoraNetworkServer::AddGateway (Ptr<LoraNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  Ptr<MacLoraAca> mac = DynamicCast<MacLoraAca> (device->GetMac ());
+  NS_ASSERT_MSG (mac, "Gateway MAC must be a MacLoraAca");
+
+  LoraAddress addr = LoraAddress::ConvertFrom (mac->GetAddress ());
+  NS_ASSERT_MSG (m_gwIndex.find (addr.GetAsInt ()) == m_gwIndex.end (), "Gateway " << addr << " added twice");
+
+  m_gwIndex[addr.GetAsInt ()] = m_gateways.size ();
+  m_gateways.push_back (device);
+  GatewayStats stats = { 0, 0, 0, 0 };
+  m_stats.push_back (stats);
+  mac->SetUplinkCallback (MakeCallback (&LoraNetworkServer::Receive, this));
+}
+
+uint32_t
+LoraNetworkServer::GetNGateways (void) const
+{
+  return m_gateways.size ();
+}
+
+Ptr<LoraNetDevice>
+LoraNetworkServer::GetGateway (uint32_t i) const
+{
+  NS_ASSERT (i < m_gateways.size ());
+  return m_gateways[i];
+}
+
+const LoraNetworkServer::GatewayStats &
+LoraNetworkServer::GetGatewayStats (uint32_t i) const
+{
+  NS_ASSERT (i < m_stats.size ());
+  return m_stats[i];
+}
+
+const std::vector<uint32_t> &
+LoraNetworkServer::GetCopiesHistogram (void) const
+{
+  return m_copiesHistogram;
+}
+
+void
+LoraNetworkServer::Flush (void)
+{
+  Expire (Time::Max ());
+}
+
+void
+LoraNetworkServer::SetReceiveCallback (Callback<void, Ptr<Packet>, const LoraAddress& > cb)
+{
+  m_recvCb = cb;
+}
+
+Ptr<LoraNetDevice>
+LoraNetworkServer::GetDownlinkGateway (const LoraAddress &dest) const
+{
+  std::unordered_map<uint32_t, Device>::const_iterator it = m_devices.find (dest.GetAsInt ());
+  if (it == m_devices.end ())
+    {
+      return 0;
+    }
+  return m_gateways[it->second.m_gw];
+}
+
+bool
+LoraNetworkServer::SendDownlink (Ptr<Packet> pkt, const LoraAddress &dest, uint16_t protocolNumber)
+{
+  Ptr<LoraNetDevice> gw = GetDownlinkGateway (dest);
+  if (!gw)
+    {
+      NS_LOG_DEBUG ("No gateway to reach " << dest);
+      return false;
+    }
+  return gw->Send (pkt, dest, protocolNumber);
+}
+
+uint32_t
+LoraNetworkServer::MakeKey (const LoraAddress &src, uint16_t frameCounter)
+{
+  return (static_cast<uint32_t> (src.GetAsInt ()) << 16) | frameCounter;
+}
+
+void
+LoraNetworkServer::Receive (Ptr<Packet> pkt, const LoraAddress &src, double sinr, const LoraAddress &gateway)
+{
+  std::unordered_map<uint32_t, uint32_t>::const_iterator gwIt = m_gwIndex.find (gateway.GetAsInt ());
+  NS_ASSERT (gwIt != m_gwIndex.end ());
+  if (m_gwIndex.find (src.GetAsInt ()) != m_gwIndex.end ())
+    {
+      // A downlink, or any frame from a gateway, overheard by another one.
+      NS_LOG_DEBUG ("Frame from gateway " << src << " via " << gateway << " dropped");
+      return;
+    }
+  uint32_t gw = gwIt->second;
+  ++m_stats[gw].m_received;
+
+  Time now = Simulator::Now ();
+  Expire (now - m_window);
+
+  LoraFrameCounterTag tag;
+  if (!pkt->PeekPacketTag (tag))
+    {
+      // Copies cannot be told apart without a frame counter.
+      NS_LOG_DEBUG ("Uplink from " << src << " without frame counter, delivered as is");
+      m_uplinkTrace (pkt, src, gateway, sinr);
+      if (!m_recvCb.IsNull ())
+        {
+          m_recvCb (pkt, src);
+        }
+      return;
+    }
+  uint16_t frameCounter = tag.GetFrameCounter ();
+  uint32_t key = MakeKey (src, frameCounter);
+
+  std::unordered_map<uint32_t, Uplink>::iterator it = m_uplinks.find (key);
+  if (it == m_uplinks.end ())
+    {
+      NS_LOG_DEBUG (now.GetSeconds () << " NS: uplink " << frameCounter << " from " << src
+                                      << " via " << gateway << " sinr " << sinr);
+      Uplink uplink = { gw, sinr, 1 };
+      m_uplinks[key] = uplink;
+      m_expiry.push_back (std::make_pair (now, key));
+      ++m_stats[gw].m_first;
+
+      Device &device = m_devices[src.GetAsInt ()];
+      device.m_frameCounter = frameCounter;
+      device.m_gw = gw;
+
+      m_uplinkTrace (pkt, src, gateway, sinr);
+      if (!m_recvCb.IsNull ())
+        {
+          m_recvCb (pkt, src);
+        }
+      return;
+    }
+
+  Uplink &uplink = it->second;
+  ++uplink.m_copies;
+  if (sinr > uplink.m_bestSinr)
+    {
+      uplink.m_bestSinr = sinr;
+      uplink.m_bestGw = gw;
+      std::unordered_map<uint32_t, Device>::iterator dev = m_devices.find (src.GetAsInt ());
+      if (dev != m_devices.end () && dev->second.m_frameCounter == frameCounter)
+        {
+          dev->second.m_gw = gw;
+        }
+    }
+  NS_LOG_DEBUG (now.GetSeconds () << " NS: duplicate " << frameCounter << " from " << src
+                                  << " via " << gateway << " sinr " << sinr);
+  m_duplicateTrace (pkt, src, gateway, sinr);
+}
+
+void
+LoraNetworkServer::Expire (Time limit)
+{
+  while (!m_expiry.empty () && m_expiry.front ().first <= limit)
+    {
+      std::unordered_map<uint32_t, Uplink>::iterator it = m_uplinks.find (m_expiry.front ().second);
+      NS_ASSERT (it != m_uplinks.end ());
+      Close (it->second);
+      m_uplinks.erase (it);
+      m_expiry.pop_front ();
+    }
+}
+
+void
+LoraNetworkServer::Close (const Uplink &uplink)
+{
+  ++m_stats[uplink.m_bestGw].m_selected;
+  if (uplink.m_copies == 1)
+    {
+      ++m_stats[uplink.m_bestGw].m_unique;
+    }
+  if (uplink.m_copies >= m_copiesHistogram.size ())
+    {
+      m_copiesHistogram.resize (uplink.m_copies + 1, 0);
+    }
+  ++m_copiesHistogram[uplink.m_copies];
+}
+
+} // namespace ns3
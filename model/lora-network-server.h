@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LORA_NETWORK_SERVER_H
+#define LORA_NETWORK_SERVER_H
+
+#include "ns3/object.h"
+#include "ns3/packet.h"
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
+#include "ns3/traced-callback.h"
+#include "lora-address.h"
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+
+class LoraNetworkServerTest;
+
+namespace ns3 {
+
+class LoraNetDevice;
+
+/**
+ *
+ * Network server collecting the uplinks received by several gateways.
+ *
+ * Every gateway MacLoraAca reports the frames it decodes.  Copies of
+ * one uplink are identified by the source address and the frame
+ * counter (LoraFrameCounterTag) and merged inside a time window
+ * starting at the first copy: the first copy is delivered, the next
+ * ones only update the best gateway of the uplink, which is then used
+ * for downlinks to that device.  Uplinks without a frame counter
+ * cannot be told apart and are delivered as is, every copy of them.
+ * Per-gateway statistics record how much each gateway contributes to
+ * the macro-diversity.  Frames sent by a registered gateway, such as
+ * downlinks overheard by another gateway, are not uplinks and are
+ * dropped.
+ */
+class LoraNetworkServer : public Object
+{
+public:
+  /**
+   * Per-gateway diversity statistics.
+   */
+  struct GatewayStats
+  {
+    uint32_t m_received;  //!< Copies received, duplicates included.
+    uint32_t m_first;     //!< Uplinks this gateway received first.
+    uint32_t m_selected;  //!< Closed uplinks this gateway received with the best SINR.
+    uint32_t m_unique;    //!< Closed uplinks received by this gateway only.
+  };
+
+  /** Default constructor */
+  LoraNetworkServer ();
+  /** Dummy destructor, see DoDispose. */
+  virtual ~LoraNetworkServer ();
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * Add a gateway.  Its MAC must be a MacLoraAca.
+   *
+   * \param device The gateway net device.
+   */
+  void AddGateway (Ptr<LoraNetDevice> device);
+  /** \return The number of gateways. */
+  uint32_t GetNGateways (void) const;
+  /**
+   * Get a gateway.
+   *
+   * \param i Gateway index, in order of addition.
+   * \return The gateway net device.
+   */
+  Ptr<LoraNetDevice> GetGateway (uint32_t i) const;
+  /**
+   * Get the statistics of a gateway.
+   *
+   * Only uplinks whose window is closed are accounted in m_selected
+   * and m_unique, see Flush.
+   *
+   * \param i Gateway index, in order of addition.
+   * \return The statistics.
+   */
+  const GatewayStats &GetGatewayStats (uint32_t i) const;
+  /**
+   * Get the number of closed uplinks per number of copies received.
+   *
+   * \return Histogram indexed by the number of copies.
+   */
+  const std::vector<uint32_t> &GetCopiesHistogram (void) const;
+
+  /** Close the windows of all uplinks and account them in the statistics. */
+  void Flush (void);
+
+  /**
+   * Set the callback delivering deduplicated uplinks.
+   *
+   * \param cb The callback.
+   * \pname{packet} The packet.
+   * \pname{address} The source address.
+   */
+  void SetReceiveCallback (Callback<void, Ptr<Packet>, const LoraAddress& > cb);
+
+  /**
+   * Get the gateway to use for a downlink, the one which received the
+   * last uplink of the device with the best SINR.
+   *
+   * \param dest The device address.
+   * \return The gateway net device, or 0 if nothing was received from dest.
+   */
+  Ptr<LoraNetDevice> GetDownlinkGateway (const LoraAddress &dest) const;
+  /**
+   * Send a downlink through the gateway returned by GetDownlinkGateway.
+   *
+   * \param pkt The packet.
+   * \param dest The device address.
+   * \param protocolNumber Protocol number passed to the gateway.
+   * \return True if the gateway accepted the packet.
+   */
+  bool SendDownlink (Ptr<Packet> pkt, const LoraAddress &dest, uint16_t protocolNumber);
+
+  /**
+   * TracedCallback signature for uplink copies.
+   *
+   * \param [in] packet The packet.
+   * \param [in] src The source address.
+   * \param [in] gateway The address of the receiving gateway.
+   * \param [in] sinr The SINR of the copy.
+   */
+  typedef void (* UplinkTracedCallback)
+    (Ptr<const Packet> packet, const LoraAddress &src,
+     const LoraAddress &gateway, double sinr);
+
+protected:
+  virtual void DoDispose ();
+
+private:
+  friend class ::LoraNetworkServerTest;
+
+  /** State of an uplink inside its deduplication window. */
+  struct Uplink
+  {
+    uint32_t m_bestGw;    //!< Index of the gateway with the best SINR.
+    double m_bestSinr;    //!< Best SINR of the copies, in dB.
+    uint32_t m_copies;    //!< Number of copies received.
+  };
+  /** Gateway of the last uplink of a device. */
+  struct Device
+  {
+    uint16_t m_frameCounter;  //!< Frame counter of the last uplink.
+    uint32_t m_gw;            //!< Index of its best gateway.
+  };
+
+  /**
+   * Receive a copy of an uplink from a gateway MAC.
+   *
+   * \param pkt The packet, without the common header.
+   * \param src The source address.
+   * \param sinr The SINR of the copy.
+   * \param gateway The gateway address.
+   */
+  void Receive (Ptr<Packet> pkt, const LoraAddress &src, double sinr, const LoraAddress &gateway);
+  /**
+   * Close the windows started at or before a given time.
+   *
+   * \param limit Latest start time of the windows to close.
+   */
+  void Expire (Time limit);
+  /**
+   * Account a closed uplink in the statistics.
+   *
+   * \param uplink The uplink.
+   */
+  void Close (const Uplink &uplink);
+
+  /**
+   * Build the deduplication key of an uplink.
+   *
+   * \param src The source address.
+   * \param frameCounter The frame counter.
+   * \return The key.
+   */
+  static uint32_t MakeKey (const LoraAddress &src, uint16_t frameCounter);
+
+  Time m_window;                                     //!< Deduplication window.
+  std::vector<Ptr<LoraNetDevice> > m_gateways;       //!< Gateway net devices.
+  std::vector<GatewayStats> m_stats;                 //!< Per-gateway statistics.
+  std::unordered_map<uint32_t, uint32_t> m_gwIndex;  //!< Gateway index, by MAC address as an integer.
+  std::unordered_map<uint32_t, Uplink> m_uplinks;    //!< Uplinks inside their window, by key.
+  std::deque<std::pair<Time, uint32_t> > m_expiry;   //!< Window start and key, oldest first.
+  std::unordered_map<uint32_t, Device> m_devices;    //!< Downlink gateway, by device address as an integer.
+  std::vector<uint32_t> m_copiesHistogram;           //!< Closed uplinks per number of copies.
+  Callback<void, Ptr<Packet>, const LoraAddress& > m_recvCb;  //!< Delivery callback.
+
+  /** A new uplink was received and delivered. */
+  TracedCallback<Ptr<const Packet>, const LoraAddress&, const LoraAddress&, double> m_uplinkTrace;
+  /** A duplicate copy of an uplink was received and dropped. */
+  TracedCallback<Ptr<const Packet>, const LoraAddress&, const LoraAddress&, double> m_duplicateTrace;
+
+};  // class LoraNetworkServer
+
+} // namespace ns3
+
+#endif /* LORA_NETWORK_SERVER_H */
@@ -22,6 +22,10 @@
 #define LORA_PHY_DUAL_H
 
 #include "ns3/lora-phy.h"
+#include "ns3/traced-value.h"
+
+#include <list>
+#include <vector>
 
 
 
@@ -29,6 +33,7 @@ namespace ns3 {
 
 class LoraTxMode;
 class LoraModesList;
+class LoraPhyGen;
 
 
 /**
@@ -57,9 +62,51 @@ public:
                              LoraPdp pdp,
                              const LoraTransducer::ArrivalList &arrivalList
                              ) const;
+  virtual double CalcSinrDbFromTransducer (Ptr<Packet> pkt,
+                                           Time arrTime,
+                                           double rxPowerDb,
+                                           double ambNoiseDb,
+                                           LoraTxMode mode,
+                                           LoraPdp pdp,
+                                           const LoraTransducer &trans) const;
 
 };  // class LoraPhyCalcSinrDual
 
+/**
+ * Multi-channel gateway PHY.
+ *
+ * Holds a configurable number of LoraPhyGen sub-PHYs sharing one
+ * transducer, each demodulating its own list of modes.  The mode
+ * numbers of this PHY are the concatenation of the sub-PHY mode
+ * lists, in sub-PHY order; a table from mode number to sub-PHY is
+ * rebuilt whenever a sub-PHY mode list changes.
+ *
+ * Sub-PHYs are configured through the indexed accessors below,
+ * the modes of all of them through the PhyModes attribute, or, for
+ * the first NUMBERED_PHYS sub-PHYs, through the per-index PhyN
+ * attributes.  The SubPhys attribute lists the instantiated sub-PHYs
+ * under their sub-PHY index.  A sub-PHY is only instantiated once it
+ * is given a non-empty mode list; until then its settings are kept in
+ * a small per-slot record.  Sub-PHYs left with the default PER and SINR models
+ * share one instance of each, owned by this PHY.
+ *
+ * Only Phy1 defaults to the LoraPhyGen default modes; the other
+ * SupportedModesPhyN attributes default to an empty list, so an
+ * unconfigured PHY has a single sub-PHY.  Earlier versions gave the
+ * default modes to all 18 sub-PHYs, so every sub-PHY left unconfigured
+ * also received the frames sent in those modes.  Set the modes of each
+ * sub-PHY, for instance through PhyModes, to get that layout back.
+ *
+ * All sub-PHYs sit on the same transducer, which evaluates the noise
+ * of each mode once and the interference of each band once per
+ * arrival event; sibling sub-PHYs only read those figures back.
+ *
+ * Setting the Demodulators attribute models the shared pool of
+ * demodulation paths of a gateway front-end: a sub-PHY locks one
+ * demodulator when it detects a preamble and frees it when the
+ * reception ends, and preambles detected while every demodulator is
+ * busy are dropped.
+ */
 class LoraPhyDual : public LoraPhy
 {
 public:
@@ -74,6 +121,9 @@ public:
    */
   static TypeId GetTypeId ();
 
+  /** Number of sub-PHYs with per-index PhyN attributes. */
+  static const uint32_t NUMBERED_PHYS = 18;
+
   // Inherited methods:
   virtual void SetEnergyModelCallback (DeviceEnergyModel::ChangeStateCallback callback);
   virtual void EnergyDepletionHandler (void);
@@ -114,497 +164,296 @@ public:
   }
   int64_t AssignStreams (int64_t stream);
   Ptr<Packet> GetPacketRx (void) const;
-  
-
-  /** \copydoc LoraPhy::IsStateIdle */
-  bool IsPhy1Idle (void);
-  /** \copydoc LoraPhy::IsStateIdle */
-  bool IsPhy2Idle (void);
-  /** \copydoc LoraPhy::IsStateRx */
-  bool IsPhy1Rx (void);
-
-  bool IsPhy2Rx (void);
-
-  bool IsPhy1Tx (void);
-
-  bool IsPhy2Tx (void);
-
-  bool IsPhy3Idle (void);
-  bool IsPhy4Idle (void);
-
-  bool IsPhy3Rx (void);
-  bool IsPhy4Rx (void);
-
-  bool IsPhy3Tx (void);
-  bool IsPhy4Tx (void);
-
-  bool IsPhy5Idle (void);
-  bool IsPhy6Idle (void);
-
-  bool IsPhy5Rx (void);
-  bool IsPhy6Rx (void);
-
-  bool IsPhy5Tx (void);
-  bool IsPhy6Tx (void);
-  
-  bool IsPhy7Idle (void);
-  bool IsPhy8Idle (void);
-
-  bool IsPhy7Rx (void);
-  bool IsPhy8Rx (void);
-
-  bool IsPhy7Tx (void);
-  bool IsPhy8Tx (void);
-
-  bool IsPhy9Idle (void);
-  bool IsPhy10Idle (void);
-
-  bool IsPhy9Rx (void);
-  bool IsPhy10Rx (void);
-
-  bool IsPhy9Tx (void);
-  bool IsPhy10Tx (void);
-  
-  bool IsPhy11Idle (void);
-  bool IsPhy12Idle (void);
-
-  bool IsPhy11Rx (void);
-  bool IsPhy12Rx (void);
-
-  bool IsPhy11Tx (void);
-  bool IsPhy12Tx (void);
-
-  bool IsPhy13Idle (void);
-  bool IsPhy14Idle (void);
-
-  bool IsPhy13Rx (void);
-  bool IsPhy14Rx (void);
-
-  bool IsPhy13Tx (void);
-  bool IsPhy14Tx (void);
-  
-  bool IsPhy15Idle (void);
-  bool IsPhy16Idle (void);
-
-  bool IsPhy15Rx (void);
-  bool IsPhy16Rx (void);
-
-  bool IsPhy15Tx (void);
-  bool IsPhy16Tx (void);
-
-  bool IsPhy17Idle (void);
-  bool IsPhy18Idle (void);
-
-  bool IsPhy17Rx (void);
-  bool IsPhy18Rx (void);
-
-  bool IsPhy17Tx (void);
-  bool IsPhy18Tx (void);
-
-
-  // Attribute getters and setters
-  /** \copydoc ns3::LoraPhy::GetCcaThresholdDb() */
-  double GetCcaThresholdPhy1 (void) const;
-  /** \copydoc LoraPhy::GetCcaThresholdDb() */
-  double GetCcaThresholdPhy2 (void) const;
-
-  void SetCcaThresholdPhy1 (double thresh);
-  void SetCcaThresholdPhy2 (double thresh);
-
-  double GetCcaThresholdPhy3 (void) const;
-  double GetCcaThresholdPhy4 (void) const;
-  void SetCcaThresholdPhy3 (double thresh);
-  void SetCcaThresholdPhy4 (double thresh);
-
-  double GetCcaThresholdPhy5 (void) const;
-  double GetCcaThresholdPhy6 (void) const;
-  void SetCcaThresholdPhy5 (double thresh);
-  void SetCcaThresholdPhy6 (double thresh);
-  
-  double GetCcaThresholdPhy7 (void) const;
-  double GetCcaThresholdPhy8 (void) const;
-  void SetCcaThresholdPhy7 (double thresh);
-  void SetCcaThresholdPhy8 (double thresh);
-
-  double GetCcaThresholdPhy9 (void) const;
-  double GetCcaThresholdPhy10 (void) const;
-  void SetCcaThresholdPhy9 (double thresh);
-  void SetCcaThresholdPhy10 (double thresh);
-  
-  double GetCcaThresholdPhy11 (void) const;
-  double GetCcaThresholdPhy12 (void) const;
-  void SetCcaThresholdPhy11 (double thresh);
-  void SetCcaThresholdPhy12 (double thresh);
-
-  double GetCcaThresholdPhy13 (void) const;
-  double GetCcaThresholdPhy14 (void) const;
-  void SetCcaThresholdPhy13 (double thresh);
-  void SetCcaThresholdPhy14 (double thresh);
-  
-  double GetCcaThresholdPhy15 (void) const;
-  double GetCcaThresholdPhy16 (void) const;
-  void SetCcaThresholdPhy15 (double thresh);
-  void SetCcaThresholdPhy16 (double thresh);
-
-  double GetCcaThresholdPhy17 (void) const;
-  double GetCcaThresholdPhy18 (void) const;
-  void SetCcaThresholdPhy17 (double thresh);
-  void SetCcaThresholdPhy18 (double thresh);
-
-  /** \copydoc LoraPhy::GetTxPowerDb */
-  double GetTxPowerDbPhy1 (void) const;
-  /** \copydoc LoraPhy::GetTxPowerDb */
-  double GetTxPowerDbPhy2 (void) const;
-  void SetTxPowerDbPhy1 (double txpwr);
-  void SetTxPowerDbPhy2 (double txpwr);
-
-  double GetTxPowerDbPhy3 (void) const;
-  double GetTxPowerDbPhy4 (void) const;
-  void SetTxPowerDbPhy3 (double txpwr);
-  void SetTxPowerDbPhy4 (double txpwr);
-
-  double GetTxPowerDbPhy5 (void) const;
-  double GetTxPowerDbPhy6 (void) const;
-  void SetTxPowerDbPhy5 (double txpwr);
-  void SetTxPowerDbPhy6 (double txpwr);
- 
-  double GetTxPowerDbPhy7 (void) const;
-  double GetTxPowerDbPhy8 (void) const;
-  void SetTxPowerDbPhy7 (double txpwr);
-  void SetTxPowerDbPhy8 (double txpwr);
-
-  double GetTxPowerDbPhy9 (void) const;
-  double GetTxPowerDbPhy10 (void) const;
-  void SetTxPowerDbPhy9 (double txpwr);
-  void SetTxPowerDbPhy10 (double txpwr);
-  
-  double GetTxPowerDbPhy11 (void) const;
-  double GetTxPowerDbPhy12 (void) const;
-  void SetTxPowerDbPhy11 (double txpwr);
-  void SetTxPowerDbPhy12 (double txpwr);
-
-  double GetTxPowerDbPhy13 (void) const;
-  double GetTxPowerDbPhy14 (void) const;
-  void SetTxPowerDbPhy13 (double txpwr);
-  void SetTxPowerDbPhy14 (double txpwr);
-  
-  double GetTxPowerDbPhy15 (void) const;
-  double GetTxPowerDbPhy16 (void) const;
-  void SetTxPowerDbPhy15 (double txpwr);
-  void SetTxPowerDbPhy16 (double txpwr);
-
-  double GetTxPowerDbPhy17 (void) const;
-  double GetTxPowerDbPhy18 (void) const;
-  void SetTxPowerDbPhy17 (double txpwr);
-  void SetTxPowerDbPhy18 (double txpwr);
-
-  /** \copydoc LoraPhy::GetRxGainDb */
-  double GetRxGainDbPhy1 (void) const;
-  /** \copydoc LoraPhy::GetRxGainDb */
-  double GetRxGainDbPhy2 (void) const;
-
-  void SetRxGainDbPhy1 (double gain);
-  void SetRxGainDbPhy2 (double gain);
-
-  double GetRxGainDbPhy3 (void) const;
-  double GetRxGainDbPhy4 (void) const;
-  void SetRxGainDbPhy3 (double gain);
-  void SetRxGainDbPhy4 (double gain);
-
-  double GetRxGainDbPhy5 (void) const;
-  double GetRxGainDbPhy6 (void) const;
-  void SetRxGainDbPhy5 (double gain);
-  void SetRxGainDbPhy6 (double gain);
-  
-  double GetRxGainDbPhy7 (void) const;
-  double GetRxGainDbPhy8 (void) const;
-  void SetRxGainDbPhy7 (double gain);
-  void SetRxGainDbPhy8 (double gain);
-
-  double GetRxGainDbPhy9 (void) const;
-  double GetRxGainDbPhy10 (void) const;
-  void SetRxGainDbPhy9 (double gain);
-  void SetRxGainDbPhy10 (double gain);
-
-  double GetRxGainDbPhy11 (void) const;
-  double GetRxGainDbPhy12 (void) const;
-  void SetRxGainDbPhy11 (double gain);
-  void SetRxGainDbPhy12 (double gain);
-
-  double GetRxGainDbPhy13 (void) const;
-  double GetRxGainDbPhy14 (void) const;
-  void SetRxGainDbPhy13 (double gain);
-  void SetRxGainDbPhy14 (double gain);  
-  
-  double GetRxGainDbPhy15 (void) const;
-  double GetRxGainDbPhy16 (void) const;
-  void SetRxGainDbPhy15 (double gain);
-  void SetRxGainDbPhy16 (double gain);
-
-  double GetRxGainDbPhy17 (void) const;
-  double GetRxGainDbPhy18 (void) const;
-  void SetRxGainDbPhy17 (double gain);
-  void SetRxGainDbPhy18 (double gain);  
 
   /**
-   * Get the list of available modes.
+   * Get the number of sub-PHYs.
    *
-   * \return The mode list.
+   * \return The number of sub-PHYs.
    */
-  LoraModesList GetModesPhy1 (void) const;
-  /** \copydoc GetModesPhy1 */
-  LoraModesList GetModesPhy2 (void) const;
-
-  LoraModesList GetModesPhy3 (void) const;
-  LoraModesList GetModesPhy4 (void) const;
-
-  LoraModesList GetModesPhy5 (void) const;
-  LoraModesList GetModesPhy6 (void) const;
-  
-  LoraModesList GetModesPhy7 (void) const;
-  LoraModesList GetModesPhy8 (void) const;
-
-  LoraModesList GetModesPhy9 (void) const;
-  LoraModesList GetModesPhy10 (void) const;
-  
-  
-  LoraModesList GetModesPhy11 (void) const;
-  LoraModesList GetModesPhy12 (void) const;
-
-  LoraModesList GetModesPhy13 (void) const;
-  LoraModesList GetModesPhy14 (void) const;
-  
-  LoraModesList GetModesPhy15 (void) const;
-  LoraModesList GetModesPhy16 (void) const;
-
-  LoraModesList GetModesPhy17 (void) const;
-  LoraModesList GetModesPhy18 (void) const;
-
+  uint32_t GetNPhys (void) const;
   /**
-   * Set the available modes.
-   * 
-   * \param modes List of modes.
+   * Get a sub-PHY.
+   *
+   * \param i The sub-PHY index, starting at 0.
+   * \return The sub-PHY, or 0 if it has no modes and was not instantiated.
    */
-  void SetModesPhy1 (LoraModesList modes);
-  /** \copydoc SetModesPhy1 */
-  void SetModesPhy2 (LoraModesList modes);
-
-  void SetModesPhy3 (LoraModesList modes);
-  void SetModesPhy4 (LoraModesList modes);
-
-  void SetModesPhy5 (LoraModesList modes);
-  void SetModesPhy6 (LoraModesList modes);
-  
-  
-  void SetModesPhy7 (LoraModesList modes);
-  void SetModesPhy8 (LoraModesList modes);
-
-  void SetModesPhy9 (LoraModesList modes);
-  void SetModesPhy10 (LoraModesList modes);
-  
-  void SetModesPhy11 (LoraModesList modes);
-  void SetModesPhy12 (LoraModesList modes);
-
-  void SetModesPhy13 (LoraModesList modes);
-  void SetModesPhy14 (LoraModesList modes);
-  
-  
-  void SetModesPhy15 (LoraModesList modes);
-  void SetModesPhy16 (LoraModesList modes);
-
-  void SetModesPhy17 (LoraModesList modes);
-  void SetModesPhy18 (LoraModesList modes);
+  Ptr<LoraPhyGen> GetPhy (uint32_t i) const;
 
   /**
-   * Get the error probability model.
+   * \copydoc LoraPhy::IsStateIdle
+   * \param i The sub-PHY index.
+   */
+  bool IsPhyIdle (uint32_t i);
+  /**
+   * \copydoc LoraPhy::IsStateRx
+   * \param i The sub-PHY index.
+   */
+  bool IsPhyRx (uint32_t i);
+  /**
+   * \copydoc LoraPhy::IsStateTx
+   * \param i The sub-PHY index.
+   */
+  bool IsPhyTx (uint32_t i);
+  /**
+   * Get the packet currently being received by a sub-PHY.
    *
-   * \return The error model.
+   * \param i The sub-PHY index.
+   * \return The packet, or 0 if the sub-PHY is not receiving.
    */
-  Ptr<LoraPhyPer> GetPerModelPhy1 (void) const;
-  /** \copydoc GetPerModelPhy1() */
-  Ptr<LoraPhyPer> GetPerModelPhy2 (void) const;
-
-  Ptr<LoraPhyPer> GetPerModelPhy3 (void) const;
-  Ptr<LoraPhyPer> GetPerModelPhy4 (void) const;
-
-  Ptr<LoraPhyPer> GetPerModelPhy5 (void) const;
-  Ptr<LoraPhyPer> GetPerModelPhy6 (void) const;
-  
-  Ptr<LoraPhyPer> GetPerModelPhy7 (void) const;
-  Ptr<LoraPhyPer> GetPerModelPhy8 (void) const;
-
-  Ptr<LoraPhyPer> GetPerModelPhy9 (void) const;
-  Ptr<LoraPhyPer> GetPerModelPhy10 (void) const;
-  
-  Ptr<LoraPhyPer> GetPerModelPhy11 (void) const;
-  Ptr<LoraPhyPer> GetPerModelPhy12 (void) const;
-
-  Ptr<LoraPhyPer> GetPerModelPhy13 (void) const;
-  Ptr<LoraPhyPer> GetPerModelPhy14 (void) const;
-  
-  Ptr<LoraPhyPer> GetPerModelPhy15 (void) const;
-  Ptr<LoraPhyPer> GetPerModelPhy16 (void) const;
-
-  Ptr<LoraPhyPer> GetPerModelPhy17 (void) const;
-  Ptr<LoraPhyPer> GetPerModelPhy18 (void) const;
+  Ptr<Packet> GetPhyPacketRx (uint32_t i) const;
 
   /**
-   * Set the error probability model.
+   * Get the modes supported by a sub-PHY.
    *
-   * \param per The error model.
+   * \param i The sub-PHY index.
+   * \return The modes.
    */
-  void SetPerModelPhy1 (Ptr<LoraPhyPer> per);
-  /** \copydoc SetPerModelPhy1 */
-  void SetPerModelPhy2 (Ptr<LoraPhyPer> per);
-
-  void SetPerModelPhy3 (Ptr<LoraPhyPer> per);
-  void SetPerModelPhy4 (Ptr<LoraPhyPer> per);
-
-  void SetPerModelPhy5 (Ptr<LoraPhyPer> per);
-  void SetPerModelPhy6 (Ptr<LoraPhyPer> per);
-  
-  void SetPerModelPhy7 (Ptr<LoraPhyPer> per);
-  void SetPerModelPhy8 (Ptr<LoraPhyPer> per);
-
-  void SetPerModelPhy9 (Ptr<LoraPhyPer> per);
-  void SetPerModelPhy10 (Ptr<LoraPhyPer> per);
-  
-  void SetPerModelPhy11 (Ptr<LoraPhyPer> per);
-  void SetPerModelPhy12 (Ptr<LoraPhyPer> per);
-
-  void SetPerModelPhy13 (Ptr<LoraPhyPer> per);
-  void SetPerModelPhy14 (Ptr<LoraPhyPer> per);
-  
-  void SetPerModelPhy15 (Ptr<LoraPhyPer> per);
-  void SetPerModelPhy16 (Ptr<LoraPhyPer> per);
-
-  void SetPerModelPhy17 (Ptr<LoraPhyPer> per);
-  void SetPerModelPhy18 (Ptr<LoraPhyPer> per);
-
+  LoraModesList GetModesPhy (uint32_t i) const;
+  /**
+   * Set the modes supported by a sub-PHY.
+   *
+   * \param i The sub-PHY index.
+   * \param modes The modes.
+   */
+  void SetModesPhy (uint32_t i, LoraModesList modes);
+  /**
+   * Get the PER model of a sub-PHY.
+   *
+   * \param i The sub-PHY index.
+   * \return The PER model.
+   */
+  Ptr<LoraPhyPer> GetPerModelPhy (uint32_t i) const;
+  /**
+   * Set the PER model of a sub-PHY.
+   *
+   * \param i The sub-PHY index.
+   * \param per The PER model.
+   */
+  void SetPerModelPhy (uint32_t i, Ptr<LoraPhyPer> per);
   /**
-   * Get the SINR calculator.
+   * Get the SINR calculator of a sub-PHY.
    *
+   * \param i The sub-PHY index.
    * \return The SINR calculator.
    */
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy1 (void) const;
-  /** \copydoc GetSinrModelPhy1 */
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy2 (void) const;
-
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy3 (void) const;
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy4 (void) const;
-
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy5 (void) const;
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy6 (void) const;
-  
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy7 (void) const;
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy8 (void) const;
-
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy9 (void) const;
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy10 (void) const;
-  
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy11 (void) const;
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy12 (void) const;
-
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy13 (void) const;
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy14 (void) const;
-  
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy15 (void) const;
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy16 (void) const;
-
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy17 (void) const;
-  Ptr<LoraPhyCalcSinr> GetSinrModelPhy18 (void) const;
-  
+  Ptr<LoraPhyCalcSinr> GetSinrModelPhy (uint32_t i) const;
   /**
-   * Set the SINR calculator.
+   * Set the SINR calculator of a sub-PHY.
    *
-   * \param calcSinr The SINR calculator.
+   * \param i The sub-PHY index.
+   * \param sinr The SINR calculator.
    */
-  void SetSinrModelPhy1 (Ptr<LoraPhyCalcSinr> calcSinr);
-  /** \copydoc SetSinrModelPhy1 */
-  void SetSinrModelPhy2 (Ptr<LoraPhyCalcSinr> calcSinr);
-
-  void SetSinrModelPhy3 (Ptr<LoraPhyCalcSinr> calcSinr);
-  void SetSinrModelPhy4 (Ptr<LoraPhyCalcSinr> calcSinr);
-
-  void SetSinrModelPhy5 (Ptr<LoraPhyCalcSinr> calcSinr);
-  void SetSinrModelPhy6 (Ptr<LoraPhyCalcSinr> calcSinr);
-  
-  void SetSinrModelPhy7 (Ptr<LoraPhyCalcSinr> calcSinr);
-  void SetSinrModelPhy8 (Ptr<LoraPhyCalcSinr> calcSinr);
-
-  void SetSinrModelPhy9 (Ptr<LoraPhyCalcSinr> calcSinr);
-  void SetSinrModelPhy10 (Ptr<LoraPhyCalcSinr> calcSinr);
-  
-  void SetSinrModelPhy11 (Ptr<LoraPhyCalcSinr> calcSinr);
-  void SetSinrModelPhy12 (Ptr<LoraPhyCalcSinr> calcSinr);
-
-  void SetSinrModelPhy13 (Ptr<LoraPhyCalcSinr> calcSinr);
-  void SetSinrModelPhy14 (Ptr<LoraPhyCalcSinr> calcSinr);
-  
-  void SetSinrModelPhy15 (Ptr<LoraPhyCalcSinr> calcSinr);
-  void SetSinrModelPhy16 (Ptr<LoraPhyCalcSinr> calcSinr);
-
-  void SetSinrModelPhy17 (Ptr<LoraPhyCalcSinr> calcSinr);
-  void SetSinrModelPhy18 (Ptr<LoraPhyCalcSinr> calcSinr);
-
-  
-  /** \copydoc LoraPhy::GetPacketRx */
-  Ptr<Packet> GetPhy1PacketRx (void) const;
-  Ptr<Packet> GetPhy2PacketRx (void) const;
-
-  Ptr<Packet> GetPhy3PacketRx (void) const;
-  Ptr<Packet> GetPhy4PacketRx (void) const;
-
-  Ptr<Packet> GetPhy5PacketRx (void) const;
-  Ptr<Packet> GetPhy6PacketRx (void) const;
-  
-  Ptr<Packet> GetPhy7PacketRx (void) const;
-  Ptr<Packet> GetPhy8PacketRx (void) const;
-
-  Ptr<Packet> GetPhy9PacketRx (void) const;
-  Ptr<Packet> GetPhy10PacketRx (void) const;
-  
-  Ptr<Packet> GetPhy11PacketRx (void) const;
-  Ptr<Packet> GetPhy12PacketRx (void) const;
-
-  Ptr<Packet> GetPhy13PacketRx (void) const;
-  Ptr<Packet> GetPhy14PacketRx (void) const;
-  
-  Ptr<Packet> GetPhy15PacketRx (void) const;
-  Ptr<Packet> GetPhy16PacketRx (void) const;
-
-  Ptr<Packet> GetPhy17PacketRx (void) const;
-  Ptr<Packet> GetPhy18PacketRx (void) const;
+  void SetSinrModelPhy (uint32_t i, Ptr<LoraPhyCalcSinr> sinr);
 
+  /**
+   * \name Numbered sub-PHY queries.
+   *
+   * \deprecated Sub-PHY N is the sub-PHY of index N - 1: use IsPhyIdle,
+   * IsPhyRx, IsPhyTx and GetPhyPacketRx instead.  Kept for the first
+   * NUMBERED_PHYS sub-PHYs.
+   */
+  /**@{*/
+  bool IsPhy1Idle (void) NS_DEPRECATED;
+  bool IsPhy2Idle (void) NS_DEPRECATED;
+  bool IsPhy3Idle (void) NS_DEPRECATED;
+  bool IsPhy4Idle (void) NS_DEPRECATED;
+  bool IsPhy5Idle (void) NS_DEPRECATED;
+  bool IsPhy6Idle (void) NS_DEPRECATED;
+  bool IsPhy7Idle (void) NS_DEPRECATED;
+  bool IsPhy8Idle (void) NS_DEPRECATED;
+  bool IsPhy9Idle (void) NS_DEPRECATED;
+  bool IsPhy10Idle (void) NS_DEPRECATED;
+  bool IsPhy11Idle (void) NS_DEPRECATED;
+  bool IsPhy12Idle (void) NS_DEPRECATED;
+  bool IsPhy13Idle (void) NS_DEPRECATED;
+  bool IsPhy14Idle (void) NS_DEPRECATED;
+  bool IsPhy15Idle (void) NS_DEPRECATED;
+  bool IsPhy16Idle (void) NS_DEPRECATED;
+  bool IsPhy17Idle (void) NS_DEPRECATED;
+  bool IsPhy18Idle (void) NS_DEPRECATED;
+
+  bool IsPhy1Rx (void) NS_DEPRECATED;
+  bool IsPhy2Rx (void) NS_DEPRECATED;
+  bool IsPhy3Rx (void) NS_DEPRECATED;
+  bool IsPhy4Rx (void) NS_DEPRECATED;
+  bool IsPhy5Rx (void) NS_DEPRECATED;
+  bool IsPhy6Rx (void) NS_DEPRECATED;
+  bool IsPhy7Rx (void) NS_DEPRECATED;
+  bool IsPhy8Rx (void) NS_DEPRECATED;
+  bool IsPhy9Rx (void) NS_DEPRECATED;
+  bool IsPhy10Rx (void) NS_DEPRECATED;
+  bool IsPhy11Rx (void) NS_DEPRECATED;
+  bool IsPhy12Rx (void) NS_DEPRECATED;
+  bool IsPhy13Rx (void) NS_DEPRECATED;
+  bool IsPhy14Rx (void) NS_DEPRECATED;
+  bool IsPhy15Rx (void) NS_DEPRECATED;
+  bool IsPhy16Rx (void) NS_DEPRECATED;
+  bool IsPhy17Rx (void) NS_DEPRECATED;
+  bool IsPhy18Rx (void) NS_DEPRECATED;
+
+  bool IsPhy1Tx (void) NS_DEPRECATED;
+  bool IsPhy2Tx (void) NS_DEPRECATED;
+  bool IsPhy3Tx (void) NS_DEPRECATED;
+  bool IsPhy4Tx (void) NS_DEPRECATED;
+  bool IsPhy5Tx (void) NS_DEPRECATED;
+  bool IsPhy6Tx (void) NS_DEPRECATED;
+  bool IsPhy7Tx (void) NS_DEPRECATED;
+  bool IsPhy8Tx (void) NS_DEPRECATED;
+  bool IsPhy9Tx (void) NS_DEPRECATED;
+  bool IsPhy10Tx (void) NS_DEPRECATED;
+  bool IsPhy11Tx (void) NS_DEPRECATED;
+  bool IsPhy12Tx (void) NS_DEPRECATED;
+  bool IsPhy13Tx (void) NS_DEPRECATED;
+  bool IsPhy14Tx (void) NS_DEPRECATED;
+  bool IsPhy15Tx (void) NS_DEPRECATED;
+  bool IsPhy16Tx (void) NS_DEPRECATED;
+  bool IsPhy17Tx (void) NS_DEPRECATED;
+  bool IsPhy18Tx (void) NS_DEPRECATED;
+
+  Ptr<Packet> GetPhy1PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy2PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy3PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy4PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy5PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy6PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy7PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy8PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy9PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy10PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy11PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy12PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy13PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy14PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy15PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy16PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy17PacketRx (void) const NS_DEPRECATED;
+  Ptr<Packet> GetPhy18PacketRx (void) const NS_DEPRECATED;
+  /**@}*/
 
 private:
-  /** First Phy layer. */
-  Ptr<LoraPhy> m_phy1;
-  Ptr<LoraPhy> m_phy2;
-
-  Ptr<LoraPhy> m_phy3;
-  Ptr<LoraPhy> m_phy4;
-
-  Ptr<LoraPhy> m_phy5;
-  Ptr<LoraPhy> m_phy6;
-  
-  Ptr<LoraPhy> m_phy7;
-  Ptr<LoraPhy> m_phy8;
-
-  Ptr<LoraPhy> m_phy9;
-  Ptr<LoraPhy> m_phy10;
-  
-  Ptr<LoraPhy> m_phy11;
-  Ptr<LoraPhy> m_phy12;
+  /**
+   * Set the number of sub-PHYs, creating or dropping sub-PHYs at the end.
+   *
+   * \param n The number of sub-PHYs.
+   */
+  void SetNPhys (uint32_t n);
+  /**
+   * Instantiate a sub-PHY from its slot settings, attached to the same
+   * channel, device, MAC and transducer as this PHY.
+   *
+   * \param i The sub-PHY index.
+   * \param modes The modes supported by the sub-PHY.
+   * \return The new sub-PHY.
+   */
+  Ptr<LoraPhyGen> CreatePhy (uint32_t i, LoraModesList modes);
+  /**
+   * Get the modes of every sub-PHY, for the PhyModes attribute.
+   *
+   * \return The mode lists, separated by ';'.
+   */
+  std::string GetPhyModes (void) const;
+  /**
+   * Set the modes of the sub-PHYs, for the PhyModes attribute.
+   *
+   * \param phyModes The mode lists, separated by ';'.
+   */
+  void SetPhyModes (std::string phyModes);
+  /**
+   * Get the PER model shared by sub-PHYs without a PerModel of their own.
+   *
+   * \return The shared PER model.
+   */
+  Ptr<LoraPhyPer> GetSharedPerModel (void) const;
+  /**
+   * Get the SINR calculator shared by sub-PHYs without a SinrModel of
+   * their own.
+   *
+   * \return The shared SINR calculator.
+   */
+  Ptr<LoraPhyCalcSinr> GetSharedSinrModel (void) const;
+  /**
+   * Lock a demodulator of the pool for a reception.
+   *
+   * \param pkt The packet whose preamble was detected.
+   * \param sinrDb The SINR of the packet.
+   * \param mode The mode of the packet.
+   * \return True if a demodulator was free.
+   */
+  bool AcquireDemodulator (Ptr<Packet> pkt, double sinrDb, LoraTxMode mode);
+  /** Free a demodulator locked by AcquireDemodulator. */
+  void ReleaseDemodulator (void);
+  /** Mark the mode number table out of date. */
+  void ModesChanged (void);
+  /** Rebuild the mode number table if it is out of date. */
+  void UpdateModeTable (void);
 
-  Ptr<LoraPhy> m_phy13;
-  Ptr<LoraPhy> m_phy14;
-  
-  Ptr<LoraPhy> m_phy15;
-  Ptr<LoraPhy> m_phy16;
+  /**
+   * Add the PhyN attributes for sub-PHYs 1 to N.
+   *
+   * \tparam N The last sub-PHY number.
+   * \param tid The TypeId to extend.
+   * \return The extended TypeId.
+   */
+  template <uint32_t N>
+  static TypeId AddPhyAttributes (TypeId tid);
 
-  Ptr<LoraPhy> m_phy17;
-  Ptr<LoraPhy> m_phy18;
+  /**
+   * \name Accessors of the PhyN attributes.
+   *
+   * Values set for sub-PHYs beyond the NumberOfPhys attribute are
+   * ignored.
+   *
+   * \tparam N The sub-PHY number, starting at 1.
+   */
+  /**@{*/
+  template <uint32_t N> double GetCcaThresholdPhyN (void) const;
+  template <uint32_t N> void SetCcaThresholdPhyN (double thresh);
+  template <uint32_t N> double GetTxPowerDbPhyN (void) const;
+  template <uint32_t N> void SetTxPowerDbPhyN (double txpwr);
+  template <uint32_t N> double GetRxGainDbPhyN (void) const;
+  template <uint32_t N> void SetRxGainDbPhyN (double gain);
+  template <uint32_t N> LoraModesList GetModesPhyN (void) const;
+  template <uint32_t N> void SetModesPhyN (LoraModesList modes);
+  template <uint32_t N> Ptr<LoraPhyPer> GetPerModelPhyN (void) const;
+  template <uint32_t N> void SetPerModelPhyN (Ptr<LoraPhyPer> per);
+  template <uint32_t N> Ptr<LoraPhyCalcSinr> GetSinrModelPhyN (void) const;
+  template <uint32_t N> void SetSinrModelPhyN (Ptr<LoraPhyCalcSinr> sinr);
+  /**@}*/
+
+  /** Settings of a sub-PHY slot, applied when the sub-PHY is instantiated. */
+  struct PhyConfig
+  {
+    double m_ccaThreshDb;          //!< CCA busy threshold.
+    double m_rxThreshDb;           //!< Deprecated reception threshold.
+    double m_txPwrDb;              //!< Transmit power.
+    double m_rxGainDb;             //!< Receive gain.
+    Ptr<LoraPhyPer> m_per;         //!< PER model, or 0 for the shared default.
+    Ptr<LoraPhyCalcSinr> m_sinr;   //!< SINR calculator, or 0 for the shared default.
+  };
+
+  std::vector<Ptr<LoraPhyGen> > m_phys; //!< Sub-PHYs, 0 until instantiated.
+  std::vector<PhyConfig> m_config;      //!< Settings of each sub-PHY slot.
+  std::list<LoraPhyListener *> m_listeners; //!< Listeners, registered on every sub-PHY.
+  Ptr<LoraPhyPer> m_sharedPer;          //!< PER model of the sub-PHYs without their own.
+  Ptr<LoraPhyCalcSinr> m_sharedSinr;    //!< SINR calculator of the sub-PHYs without their own.
+
+  /** First mode number of each sub-PHY, followed by the total number of modes. */
+  std::vector<uint32_t> m_modeOffset;
+  /** Sub-PHY index of each mode number. */
+  std::vector<uint32_t> m_modePhy;
+  /** True if m_modeOffset and m_modePhy match the sub-PHY mode lists. */
+  bool m_modeTableValid;
+
+  uint32_t m_nDemodulators;                 //!< Size of the demodulator pool, 0 for unlimited.
+  TracedValue<uint32_t> m_demodulatorsInUse; //!< Demodulators currently locked.
+  TracedValue<uint32_t> m_demodulatorDrops;  //!< Preambles dropped for lack of a demodulator.
+  /** A preamble was dropped because every demodulator was busy. */
+  ns3::TracedCallback<Ptr<const Packet>, double, LoraTxMode > m_demodDropLogger;
+
+  Ptr<LoraChannel> m_channel;       //!< Attached channel.
+  Ptr<LoraTransducer> m_transducer; //!< Associated transducer.
+  Ptr<LoraNetDevice> m_device;      //!< Device hosting this Phy.
+  Ptr<LoraMac> m_mac;               //!< MAC layer.
 
   /** A packet was received successfully. */
   ns3::TracedCallback<Ptr<const Packet>, double, LoraTxMode > m_rxOkLogger;
@@ -617,23 +466,6 @@ private:
   /** Callback when packet received with errors. */
   RxErrCallback m_recErrCb;
 
-
-  /**
-   * Handle callback and logger for packets received without error.
-   *
-   * \param pkt The packet.
-   * \param sinr The SINR.
-   * \param mode The channel mode.
-   */
-  void RxOkFromSubPhy (Ptr<Packet> pkt, double sinr, LoraTxMode mode);
-  /**
-   * Handle callback and logger for packets received with error.
-   *
-   * \param pkt The packet.
-   * \param sinr The SINR.
-   */
-  void RxErrFromSubPhy (Ptr<Packet> pkt, double sinr);
-  
 protected:
   virtual void DoDispose ();
 
@@ -34,6 +34,11 @@
 #include "ns3/uinteger.h"
 #include "ns3/energy-source-container.h"
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("LoraPhyGen");
@@ -43,6 +48,7 @@ NS_OBJECT_ENSURE_REGISTERED (LoraPhyPerGenDefault);
 NS_OBJECT_ENSURE_REGISTERED (LoraPhyCalcSinrDefault);
 NS_OBJECT_ENSURE_REGISTERED (LoraPhyCalcSinrFhFsk);
 NS_OBJECT_ENSURE_REGISTERED (LoraPhyPerUmodem);
+NS_OBJECT_ENSURE_REGISTERED (LoraPhyPerTable);
 
 
 /*************** LoraPhyCalcSinrDefault definition *****************/
@@ -93,6 +99,28 @@ LoraPhyCalcSinrDefault::CalcSinrDb (Ptr<Packet> pkt,
   return rxPowerDb - totalIntDb;
 }
 
+double
+LoraPhyCalcSinrDefault::CalcSinrDbFromTransducer (Ptr<Packet> pkt,
+                                                 Time arrTime,
+                                                 double rxPowerDb,
+                                                 double ambNoiseDb,
+                                                 LoraTxMode mode,
+                                                 LoraPdp pdp,
+                                                 const LoraTransducer &trans) const
+{
+  if (mode.GetModType () == LoraTxMode::OTHER)
+    {
+      NS_LOG_WARN ("Calculating SINR for unsupported modulation type");
+    }
+
+  // This packet is in the arrival list
+  double intKp = std::max (0.0, trans.GetRxPowerKp () - DbToKp (rxPowerDb));
+  double totalIntDb = KpToDb (intKp + DbToKp (ambNoiseDb));
+
+  NS_LOG_DEBUG ("Calculating SINR:  RxPower = " << rxPowerDb << " dB.  Interference + noise power = " << totalIntDb << " dB.  SINR = " << rxPowerDb - totalIntDb << " dB.");
+  return rxPowerDb - totalIntDb;
+}
+
 /*************** LoraPhyCalcSinrFhFsk definition *****************/
 LoraPhyCalcSinrFhFsk::LoraPhyCalcSinrFhFsk ()
 {
@@ -136,30 +164,31 @@ LoraPhyCalcSinrFhFsk::CalcSinrDb (Ptr<Packet> pkt,
 
   double ts = 1.0 / mode.GetPhyRateSps ();
   double clearingTime = (m_hops - 1.0) * ts;
-  double csp = pdp.SumTapsFromMaxNc (Seconds (0), Seconds (ts));
-
-  // Get maximum arrival offset
-  double maxAmp = -1;
+  // The unit impulse sums to 1 over any window, with its maximum at 0
+  double csp = 1.0;
   double maxTapDelay = 0.0;
-  LoraPdp::Iterator pit = pdp.GetBegin ();
-  for (; pit != pdp.GetEnd (); pit++)
+  double isiUpa = rxPowerDb;
+  if (!pdp.IsImpulse ())
     {
-      if (std::abs (pit->GetAmp ()) > maxAmp)
+      csp = pdp.SumTapsFromMaxNc (Seconds (0), Seconds (ts));
+
+      // Get maximum arrival offset
+      if (pdp.GetNTaps () > 0)
         {
-          maxAmp = std::abs (pit->GetAmp ());
-          maxTapDelay = pit->GetDelay ().GetSeconds ();
+          maxTapDelay = pdp.GetTap (pdp.GetPeakTapIndex ()).GetDelay ().GetSeconds ();
         }
+
+      isiUpa = rxPowerDb * pdp.SumTapsFromMaxNc (Seconds (ts + clearingTime), Seconds (ts));
     }
 
 
   double effRxPowerDb = rxPowerDb + KpToDb (csp);
 
-  double isiUpa = rxPowerDb * pdp.SumTapsFromMaxNc (Seconds (ts + clearingTime), Seconds (ts));
   LoraTransducer::ArrivalList::const_iterator it = arrivalList.begin ();
   double intKp = -DbToKp (effRxPowerDb);
   for (; it != arrivalList.end (); it++)
     {
-      LoraPdp intPdp = it->GetPdp ();
+      const LoraPdp &intPdp = it->GetPdp ();
       double tDelta = std::abs (arrTime.GetSeconds () + maxTapDelay - it->GetArrivalTime ().GetSeconds ());
       // We want tDelta in terms of a single symbol (i.e. if tDelta = 7.3 symbol+clearing
       // times, the offset in terms of the arriving symbol power is
@@ -342,6 +371,219 @@ LoraPhyPerUmodem::CalcPer (Ptr<Packet> pkt, double sinr, LoraTxMode mode)
     }
 }
 
+/*************** LoraPhyPerTable definition *****************/
+LoraPhyPerTable::LoraPhyPerTable ()
+{
+
+}
+LoraPhyPerTable::~LoraPhyPerTable ()
+{
+
+}
+
+TypeId
+LoraPhyPerTable::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LoraPhyPerTable")
+    .SetParent<Object> ()
+    .SetGroupName ("Lora")
+    .AddConstructor<LoraPhyPerTable> ()
+    .AddAttribute ("TableFile",
+                   "File of measured PER tables, loaded when set.",
+                   StringValue (""),
+                   MakeStringAccessor (&LoraPhyPerTable::LoadTables),
+                   MakeStringChecker ())
+    .AddAttribute ("Threshold", "SINR cutoff for good packet reception, for modes without a table.",
+                   DoubleValue (8),
+                   MakeDoubleAccessor (&LoraPhyPerTable::m_thresh),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+double
+LoraPhyPerTable::Table::Lookup (double sinrDb, uint32_t bytes) const
+{
+  // SINR row and weight of the next row
+  double row = (sinrDb - m_sinrStartDb) / m_sinrStepDb;
+  row = std::min (std::max (row, 0.0), (double)(m_nSinr - 1));
+  uint32_t r0 = static_cast<uint32_t> (row);
+  uint32_t r1 = std::min (r0 + 1, m_nSinr - 1);
+  double wr = row - r0;
+
+  // Size column and weight of the next column
+  uint32_t nSizes = m_sizes.size ();
+  uint32_t c1 = std::lower_bound (m_sizes.begin (), m_sizes.end (), bytes) - m_sizes.begin ();
+  uint32_t c0 = c1;
+  double wc = 0;
+  if (c1 == nSizes)
+    {
+      c0 = c1 = nSizes - 1;
+    }
+  else if (c1 > 0 && m_sizes[c1] != bytes)
+    {
+      c0 = c1 - 1;
+      wc = (double)(bytes - m_sizes[c0]) / (m_sizes[c1] - m_sizes[c0]);
+    }
+
+  double per0 = m_per[r0 * nSizes + c0] * (1 - wc) + m_per[r0 * nSizes + c1] * wc;
+  double per1 = m_per[r1 * nSizes + c0] * (1 - wc) + m_per[r1 * nSizes + c1] * wc;
+  return per0 * (1 - wr) + per1 * wr;
+}
+
+const LoraPhyPerTable::Table &
+LoraPhyPerTable::GetLoraTable (uint32_t sf, uint32_t codingRate,
+                               bool lowDataRateOpt, bool explicitHeader)
+{
+  NS_ASSERT (sf >= 7 && sf <= 12 && codingRate >= 1 && codingRate <= 4);
+
+  static std::vector<Table> tables (6 * 4 * 2 * 2);
+  Table &table = tables[(((sf - 7) * 4 + codingRate - 1) * 2 + lowDataRateOpt) * 2 + explicitHeader];
+  if (table.m_nSinr != 0)
+    {
+      return table;
+    }
+
+  table.m_sinrStartDb = -30;
+  table.m_sinrStepDb = 0.5;
+  table.m_nSinr = 81;
+  for (uint32_t bytes = 0; bytes <= 256; bytes += 16)
+    {
+      table.m_sizes.push_back (bytes);
+    }
+  table.m_per.resize (table.m_nSinr * table.m_sizes.size ());
+
+  // Payload CRC on, as in the time on air formula.
+  int32_t de = lowDataRateOpt ? 1 : 0;
+  int32_t ih = explicitHeader ? 0 : 1;
+  uint32_t n = 4 + codingRate;
+  for (uint32_t i = 0; i < table.m_nSinr; i++)
+    {
+      double snr = std::pow (10, (table.m_sinrStartDb + i * table.m_sinrStepDb) / 10.0);
+      // Symbol error rate of non-coherent LoRa demodulation
+      double x = std::sqrt (2.0 * (1 << sf) * snr) - std::sqrt (1.386 * sf + 1.154);
+      double p = 0.5 * std::erfc (x / std::sqrt (2.0));
+
+      // The diagonal interleaver spreads a symbol error over
+      // one bit of each codeword: Hamming 4/7 and 4/8 blocks
+      // survive one symbol error, 4/5 and 4/6 none.
+      double headerOk = 1;
+      if (explicitHeader)
+        {
+          headerOk = std::pow (1 - p, 8.0) + 8 * p * std::pow (1 - p, 7.0);
+        }
+      double blockOk = std::pow (1 - p, (double) n);
+      if (codingRate >= 3)
+        {
+          blockOk += n * p * std::pow (1 - p, n - 1.0);
+        }
+
+      for (uint32_t j = 0; j < table.m_sizes.size (); j++)
+        {
+          int32_t num = 8 * (int32_t) table.m_sizes[j] - 4 * (int32_t) sf + 28 + 16 - 20 * ih;
+          int32_t den = 4 * ((int32_t) sf - 2 * de);
+          double blocks = std::max (std::ceil ((double) num / den), 0.0);
+          table.m_per[i * table.m_sizes.size () + j] = 1 - headerOk * std::pow (blockOk, blocks);
+        }
+    }
+  return table;
+}
+
+void
+LoraPhyPerTable::LoadTables (std::string fileName)
+{
+  if (fileName.empty ())
+    {
+      return;
+    }
+  std::ifstream file (fileName.c_str ());
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("Cannot open PER table file " << fileName);
+    }
+
+  std::string line;
+  while (std::getline (file, line))
+    {
+      std::istringstream is (line);
+      std::string keyword;
+      if (!(is >> keyword) || keyword[0] == '#')
+        {
+          continue;
+        }
+      if (keyword != "table")
+        {
+          NS_FATAL_ERROR ("Unexpected \"" << keyword << "\" in PER table file " << fileName);
+        }
+
+      std::string name;
+      Table table;
+      is >> name >> table.m_sinrStartDb >> table.m_sinrStepDb >> table.m_nSinr;
+      uint32_t size;
+      while (is >> size)
+        {
+          table.m_sizes.push_back (size);
+        }
+      if (name.empty () || table.m_nSinr == 0 || table.m_sinrStepDb <= 0 || table.m_sizes.empty ())
+        {
+          NS_FATAL_ERROR ("Bad table header \"" << line << "\" in PER table file " << fileName);
+        }
+
+      table.m_per.resize (table.m_nSinr * table.m_sizes.size ());
+      for (uint32_t i = 0; i < table.m_per.size (); i++)
+        {
+          if (!(file >> table.m_per[i]))
+            {
+              NS_FATAL_ERROR ("Missing PER values for mode " << name << " in PER table file " << fileName);
+            }
+        }
+      m_fileTables[name] = table;
+      NS_LOG_DEBUG ("Loaded PER table for mode " << name);
+    }
+
+  // Tables may have changed for modes already looked up
+  m_modeTables.clear ();
+  m_modeResolved.clear ();
+}
+
+const LoraPhyPerTable::Table *
+LoraPhyPerTable::FindTable (LoraTxMode mode)
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid >= m_modeResolved.size ())
+    {
+      m_modeTables.resize (uid + 1, 0);
+      m_modeResolved.resize (uid + 1, false);
+    }
+  if (!m_modeResolved[uid])
+    {
+      std::map<std::string, Table>::const_iterator it = m_fileTables.find (mode.GetName ());
+      if (it != m_fileTables.end ())
+        {
+          m_modeTables[uid] = &it->second;
+        }
+      else if (mode.GetSpreadingFactor () != 0)
+        {
+          m_modeTables[uid] = &GetLoraTable (mode.GetSpreadingFactor (), mode.GetCodingRate (),
+                                             mode.HasLowDataRateOptimization (),
+                                             mode.HasExplicitHeader ());
+        }
+      m_modeResolved[uid] = true;
+    }
+  return m_modeTables[uid];
+}
+
+double
+LoraPhyPerTable::CalcPer (Ptr<Packet> pkt, double sinrDb, LoraTxMode mode)
+{
+  const Table *table = FindTable (mode);
+  if (table == 0)
+    {
+      return (sinrDb >= m_thresh) ? 0 : 1;
+    }
+  return table->Lookup (sinrDb, pkt->GetSize ());
+}
+
 /*************** LoraPhyGen definition *****************/
 LoraPhyGen::LoraPhyGen ()
   : LoraPhy (),
@@ -377,6 +619,9 @@ LoraPhyGen::Clear ()
     }
   m_cleared = true;
   m_listeners.clear ();
+  m_modesChangedCb = MakeNullCallback<void> ();
+  m_demodAcquireCb = MakeNullCallback<bool, Ptr<Packet>, double, LoraTxMode> ();
+  m_demodReleaseCb = MakeNullCallback<void> ();
   if (m_channel)
     {
       m_channel->Clear ();
@@ -457,7 +702,8 @@ LoraPhyGen::GetTypeId (void)
     .AddAttribute ("SupportedModes",
                    "List of modes supported by this PHY.",
                    LoraModesListValue (LoraPhyGen::GetDefaultModes ()),
-                   MakeLoraModesListAccessor (&LoraPhyGen::m_modes),
+                   MakeLoraModesListAccessor (&LoraPhyGen::SetSupportedModes,
+                                              &LoraPhyGen::GetSupportedModes),
                    MakeLoraModesListChecker () )
     .AddAttribute ("PerModel",
                    "Functor to calculate PER based on SINR and TxMode.",
@@ -541,15 +787,19 @@ LoraPhyGen::SendPacket (Ptr<Packet> pkt, uint32_t modeNum)
     {
       m_minRxSinrDb = -1e30;
       m_pktRx = 0;
+      if (!m_demodReleaseCb.IsNull ())
+        {
+          m_demodReleaseCb ();
+        }
     }
 
   m_transducer->Transmit (Ptr<LoraPhy> (this), pkt, m_txPwrDb, txMode);
   m_state = TX;
   UpdatePowerConsumption (TX);
-  double txdelay = pkt->GetSize () * 8.0 / txMode.GetDataRateBps ();
-  Simulator::Schedule (Seconds (txdelay), &LoraPhyGen::TxEndEvent, this);
+  Time txdelay = txMode.GetTimeOnAir (pkt->GetSize ());
+  Simulator::Schedule (txdelay, &LoraPhyGen::TxEndEvent, this);
   NS_LOG_DEBUG ("PHY " << m_mac->GetAddress () << " notifying listeners");
-  NotifyListenersTxStart (Seconds (txdelay));
+  NotifyListenersTxStart (txdelay);
   m_txLogger (pkt, m_txPwrDb, txMode);
 }
 
@@ -612,16 +862,7 @@ LoraPhyGen::StartRxPacket (Ptr<Packet> pkt, double rxPowerDb, LoraTxMode txMode,
     case IDLE:
       {
         NS_ASSERT (!m_pktRx);
-        bool hasmode = false;
-        for (uint32_t i = 0; i < GetNModes (); i++)
-          {
-            if (txMode.GetUid () == GetMode (i).GetUid ())
-              {
-                hasmode = true;
-                break;
-              }
-          }
-        if (!hasmode)
+        if (!SupportsMode (txMode))
           {
             break;
           }
@@ -631,6 +872,12 @@ LoraPhyGen::StartRxPacket (Ptr<Packet> pkt, double rxPowerDb, LoraTxMode txMode,
         NS_LOG_DEBUG ("PHY " << m_mac->GetAddress () << ": Starting RX in IDLE mode.  SINR = " << newsinr);
         if (newsinr > m_rxThreshDb)
           {
+            if (!m_demodAcquireCb.IsNull () && !m_demodAcquireCb (pkt, newsinr, txMode))
+              {
+                NS_LOG_DEBUG ("PHY " << m_mac->GetAddress () << ": No demodulator available.  Dropping packet.");
+                NotifyRxDrop(pkt);    // traced source netanim
+                break;
+              }
             m_state = RX;
             UpdatePowerConsumption (RX);
             NotifyRxBegin(pkt);    // traced source netanim
@@ -640,8 +887,7 @@ LoraPhyGen::StartRxPacket (Ptr<Packet> pkt, double rxPowerDb, LoraTxMode txMode,
             m_pktRxArrTime = Simulator::Now ();
             m_pktRxMode = txMode;
             m_pktRxPdp = pdp;
-            double txdelay = pkt->GetSize () * 8.0 / txMode.GetDataRateBps ();
-            Simulator::Schedule (Seconds (txdelay), &LoraPhyGen::RxEndEvent, this, pkt, rxPowerDb, txMode);
+            // The transducer ends the reception through NotifyArrivalEnd
             NotifyListenersRxStart ();
           }
 
@@ -669,6 +915,11 @@ LoraPhyGen::RxEndEvent (Ptr<Packet> pkt, double rxPowerDb, LoraTxMode txMode)
       return;
     }
 
+  if (!m_demodReleaseCb.IsNull ())
+    {
+      m_demodReleaseCb ();
+    }
+
   if (m_disabled || m_state == SLEEP)
     {
       NS_LOG_DEBUG ("Sleep mode or dead. Dropping packet");
@@ -695,7 +946,9 @@ LoraPhyGen::RxEndEvent (Ptr<Packet> pkt, double rxPowerDb, LoraTxMode txMode)
       NotifyListenersRxGood ();
       if (!m_recOkCb.IsNull ())
         {
-          m_recOkCb (pkt, m_minRxSinrDb, txMode);
+          // The arrival is shared with the other receivers, only the
+          // decoded frame gets its own copy for the upper layers.
+          m_recOkCb (pkt->Copy (), m_minRxSinrDb, txMode);
         }
 
     }
@@ -888,6 +1141,19 @@ LoraPhyGen::NotifyTransStartTx (Ptr<Packet> packet, double txPowerDb, LoraTxMode
     }
 }
 
+void
+LoraPhyGen::NotifyArrivalEnd (Ptr<Packet> pkt, double rxPowerDb, LoraTxMode txMode)
+{
+  if (pkt && pkt == m_pktRx)
+    {
+      RxEndEvent (pkt, rxPowerDb, txMode);
+    }
+  else
+    {
+      NotifyIntChange ();
+    }
+}
+
 void
 LoraPhyGen::NotifyIntChange (void)
 {
@@ -901,13 +1167,17 @@ LoraPhyGen::NotifyIntChange (void)
 double
 LoraPhyGen::CalculateSinrDb (Ptr<Packet> pkt, Time arrTime, double rxPowerDb, LoraTxMode mode, LoraPdp pdp)
 {
-  double noiseDb = m_channel->GetNoiseDbHz ( (double) mode.GetCenterFreqHz () / 1000.0) + 10 * std::log10 (mode.GetBandwidthHz ());
-  return m_sinr->CalcSinrDb (pkt, arrTime, rxPowerDb, noiseDb, mode, pdp, m_transducer->GetArrivalList ());
+  double noiseDb = m_transducer->GetNoiseDb (mode);
+  return m_sinr->CalcSinrDbFromTransducer (pkt, arrTime, rxPowerDb, noiseDb, mode, pdp, *m_transducer);
 }
 
 double
 LoraPhyGen::GetInterferenceDb (Ptr<Packet> pkt)
 {
+  if (!pkt)
+    {
+      return m_transducer->GetRxPowerDb ();
+    }
 
   const LoraTransducer::ArrivalList &arrivalList = m_transducer->GetArrivalList ();
 
@@ -1009,6 +1279,57 @@ LoraPhyGen::GetMode (uint32_t n)
   return m_modes[n];
 }
 
+bool
+LoraPhyGen::SupportsMode (LoraTxMode mode) const
+{
+  uint32_t uid = mode.GetUid ();
+  return uid < m_modeSupported.size () && m_modeSupported[uid];
+}
+
+void
+LoraPhyGen::SetSupportedModes (LoraModesList modes)
+{
+  m_modes = modes;
+  m_modeSupported.clear ();
+  for (uint32_t i = 0; i < m_modes.GetNModes (); i++)
+    {
+      uint32_t uid = m_modes[i].GetUid ();
+      if (uid >= m_modeSupported.size ())
+        {
+          m_modeSupported.resize (uid + 1, false);
+        }
+      m_modeSupported[uid] = true;
+    }
+  if (m_channel)
+    {
+      m_channel->NotifySupportedModesChanged ();
+    }
+  if (!m_modesChangedCb.IsNull ())
+    {
+      m_modesChangedCb ();
+    }
+}
+
+void
+LoraPhyGen::SetModesChangedCallback (Callback<void> cb)
+{
+  m_modesChangedCb = cb;
+}
+
+void
+LoraPhyGen::SetDemodulatorCallbacks (Callback<bool, Ptr<Packet>, double, LoraTxMode> acquire,
+                                     Callback<void> release)
+{
+  m_demodAcquireCb = acquire;
+  m_demodReleaseCb = release;
+}
+
+LoraModesList
+LoraPhyGen::GetSupportedModes (void) const
+{
+  return m_modes;
+}
+
 Ptr<Packet>
 LoraPhyGen::GetPacketRx (void) const
 {
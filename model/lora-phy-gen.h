@@ -28,6 +28,8 @@
 #include "ns3/device-energy-model.h"
 #include "ns3/random-variable-stream.h"
 #include <list>
+#include <vector>
+#include <map>
 
 namespace ns3 {
 
@@ -101,6 +103,98 @@ private:
 };  // class LoraPhyPerUmodem
 
 
+/**
+ *
+ * Table driven packet error rate calculation.
+ *
+ * The PER is read from tables of PER as a function of SINR and payload
+ * size, with linear interpolation in both. LoRa-native modes use
+ * built-in tables per spreading factor, coding rate, low data rate
+ * optimization and header mode, computed on first use from a symbol
+ * error approximation for LoRa with the LoRa interleaver and Hamming
+ * codes. Measured tables can be loaded from a file with
+ * the TableFile attribute; they take precedence for the modes they
+ * name. Modes without a table fall back to an SINR threshold.
+ *
+ * A table file holds any number of tables, each one made of a line
+ * \verbatim
+   table <mode name> <first SINR dB> <SINR step dB> <number of SINR bins> <size 1> ... <size n>
+   \endverbatim
+ * followed by one line of n PER values per SINR bin, for the listed
+ * payload sizes in bytes. Lines starting with '#' are ignored.
+ */
+class LoraPhyPerTable : public LoraPhyPer
+{
+public:
+  /** Constructor */
+  LoraPhyPerTable ();
+  /** Destructor */
+  virtual ~LoraPhyPerTable ();
+
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  virtual double CalcPer (Ptr<Packet> pkt, double sinrDb, LoraTxMode mode);
+
+  /**
+   * PER as a function of SINR and payload size.
+   */
+  struct Table
+  {
+    double m_sinrStartDb;            //!< SINR of the first row, in dB.
+    double m_sinrStepDb;             //!< SINR step between rows, in dB.
+    uint32_t m_nSinr;                //!< Number of rows.
+    std::vector<uint32_t> m_sizes;   //!< Payload size of each column, increasing, in bytes.
+    std::vector<double> m_per;       //!< PER values, row by row.
+
+    /**
+     * Interpolate the PER.
+     *
+     * \param sinrDb SINR, in dB.
+     * \param bytes Payload size, in bytes.
+     * \return The PER, clamped to the table bounds.
+     */
+    double Lookup (double sinrDb, uint32_t bytes) const;
+  };
+
+  /**
+   * Get the built-in table of a LoRa modulation.
+   *
+   * \param sf Spreading factor, 7 to 12.
+   * \param codingRate Coding rate index, 1 to 4.
+   * \param lowDataRateOpt Low data rate optimization.
+   * \param explicitHeader Explicit header.
+   * \return The table.
+   */
+  static const Table &GetLoraTable (uint32_t sf, uint32_t codingRate,
+                                    bool lowDataRateOpt, bool explicitHeader);
+
+private:
+  /**
+   * Load the tables of a file.
+   *
+   * \param fileName The file name, or an empty string for none.
+   */
+  void LoadTables (std::string fileName);
+  /**
+   * Find the table of a mode.
+   *
+   * \param mode The mode.
+   * \return The table, or 0 if the mode has none.
+   */
+  const Table *FindTable (LoraTxMode mode);
+
+  double m_thresh;                              //!< SINR threshold for modes without a table.
+  std::map<std::string, Table> m_fileTables;    //!< Tables loaded from file, by mode name.
+  std::vector<const Table *> m_modeTables;      //!< Table of each mode, indexed by uid.
+  std::vector<bool> m_modeResolved;             //!< The table of each mode was looked up.
+
+};  // class LoraPhyPerTable
+
+
 /**
  *
  * Default SINR calculator for LoraPhyGen.
@@ -144,6 +238,13 @@ public:
                              LoraPdp pdp,
                              const LoraTransducer::ArrivalList &arrivalList
                              ) const;
+  virtual double CalcSinrDbFromTransducer (Ptr<Packet> pkt,
+                                           Time arrTime,
+                                           double rxPowerDb,
+                                           double ambNoiseDb,
+                                           LoraTxMode mode,
+                                           LoraPdp pdp,
+                                           const LoraTransducer &trans) const;
 
 };  // class LoraPhyCalcSinrDefault
 
@@ -234,8 +335,37 @@ public:
   virtual void SetTransducer (Ptr<LoraTransducer> trans);
   virtual void NotifyTransStartTx (Ptr<Packet> packet, double txPowerDb, LoraTxMode txMode);
   virtual void NotifyIntChange (void);
+  virtual void NotifyArrivalEnd (Ptr<Packet> pkt, double rxPowerDb, LoraTxMode txMode);
   virtual uint32_t GetNModes (void);
   virtual LoraTxMode GetMode (uint32_t n);
+  /**
+   * Check if this PHY supports a mode.
+   *
+   * \param mode The mode.
+   * \return True if the mode is in the SupportedModes list.
+   */
+  bool SupportsMode (LoraTxMode mode) const;
+  /**
+   * Set the callback invoked whenever the SupportedModes list changes.
+   *
+   * Used by a container PHY to keep its mode number table in sync.
+   *
+   * \param cb The callback.
+   */
+  void SetModesChangedCallback (Callback<void> cb);
+  /**
+   * Set the callbacks locking and releasing a demodulator.
+   *
+   * The acquire callback is invoked with the packet, its SINR and mode
+   * when this PHY detects a preamble it could receive; reception only
+   * starts if it returns true.  The release callback is invoked when
+   * that reception ends or is aborted.
+   *
+   * \param acquire The callback locking a demodulator.
+   * \param release The callback releasing the demodulator.
+   */
+  void SetDemodulatorCallbacks (Callback<bool, Ptr<Packet>, double, LoraTxMode> acquire,
+                                Callback<void> release);
   virtual Ptr<Packet> GetPacketRx (void) const;
   virtual void Clear (void);
   virtual void SetSleepMode (bool sleep);
@@ -246,11 +376,29 @@ private:
   typedef std::list<LoraPhyListener *> ListenerList;
 
   LoraModesList m_modes;             //!< List of modes supported by this PHY.
+  std::vector<bool> m_modeSupported; //!< Modes in m_modes, indexed by uid.
+
+  /**
+   * Set the list of supported modes.
+   *
+   * \param modes The modes.
+   */
+  void SetSupportedModes (LoraModesList modes);
+  /**
+   * Get the list of supported modes.
+   *
+   * \return The modes.
+   */
+  LoraModesList GetSupportedModes (void) const;
 
   State m_state;                    //!< Phy state.
   ListenerList m_listeners;         //!< List of listeners.
   RxOkCallback m_recOkCb;           //!< Callback for packets received without error.
   RxErrCallback m_recErrCb;         //!< Callback for packets received with errors.
+  Callback<void> m_modesChangedCb;  //!< Callback for SupportedModes changes.
+  /** Callback locking a demodulator for a reception. */
+  Callback<bool, Ptr<Packet>, double, LoraTxMode> m_demodAcquireCb;
+  Callback<void> m_demodReleaseCb;  //!< Callback releasing the demodulator.
   Ptr<LoraChannel> m_channel;        //!< Attached channel.
   Ptr<LoraTransducer> m_transducer;  //!< Associated transducer.
   Ptr<LoraNetDevice> m_device;       //!< Device hosting this Phy.
@@ -328,7 +476,7 @@ private:
    */
   double KpToDb (double kp);
   /**
-   * Event to process end of packet reception.
+   * Process end of packet reception, from NotifyArrivalEnd.
    *
    * \param pkt The packet.
    * \param rxPowerDb Received signal power.
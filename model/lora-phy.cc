@@ -32,6 +32,18 @@ TypeId LoraPhyCalcSinr::GetTypeId (void)
   return tid;
 }
 
+double
+LoraPhyCalcSinr::CalcSinrDbFromTransducer (Ptr<Packet> pkt,
+                                           Time arrTime,
+                                           double rxPowerDb,
+                                           double ambNoiseDb,
+                                           LoraTxMode mode,
+                                           LoraPdp pdp,
+                                           const LoraTransducer &trans) const
+{
+  return CalcSinrDb (pkt, arrTime, rxPowerDb, ambNoiseDb, mode, pdp, trans.GetArrivalList ());
+}
+
 void
 LoraPhyCalcSinr::Clear ()
 {
@@ -115,6 +127,12 @@ LoraPhy::NotifyTxBegin (Ptr<const Packet> packet)
   m_phyTxBeginTrace (packet);
 }
 
+void
+LoraPhy::NotifyArrivalEnd (Ptr<Packet> pkt, double rxPowerDb, LoraTxMode txMode)
+{
+  NotifyIntChange ();
+}
+
 void
 LoraPhy::NotifyTxEnd (Ptr<const Packet> packet)
 {
@@ -60,6 +60,29 @@ public:
                              LoraPdp pdp,
                              const LoraTransducer::ArrivalList &arrivalList
                              ) const = 0;
+  /**
+   * Calculate the SINR value for a packet arrived at a transducer.
+   *
+   * The default implementation calls CalcSinrDb with the arrival list
+   * of the transducer. Models which only need the total interference
+   * power override it to read the transducer running sums instead.
+   *
+   * \param pkt Packet to calculate SINR for.
+   * \param arrTime Arrival time of pkt.
+   * \param rxPowerDb The received signal strength of the packet in dB re 1 uPa.
+   * \param ambNoiseDb Ambient channel noise in dB re 1 uPa.
+   * \param mode TX Mode of pkt.
+   * \param pdp  Power delay profile of pkt.
+   * \param trans The transducer pkt is arriving at.
+   * \return The SINR in dB re 1 uPa.
+   */
+  virtual double CalcSinrDbFromTransducer (Ptr<Packet> pkt,
+                                           Time arrTime,
+                                           double rxPowerDb,
+                                           double ambNoiseDb,
+                                           LoraTxMode mode,
+                                           LoraPdp pdp,
+                                           const LoraTransducer &trans) const;
   /**
    * Register this type.
    * \return The object TypeId.
@@ -181,7 +204,7 @@ public:
   /**
    * Packet received successfully callback function type.
    *
-   * \pname{arg1} Packet received successfully.
+   * \pname{arg1} Packet received successfully, a private copy.
    * \pname{arg2} SNIR of packet.
    * \pname{arg3} Mode of packet.
    */
@@ -190,7 +213,7 @@ public:
   /**
    * Packet receive error callback function type.
    *
-   * \pname{arg1} Packet received successfully.
+   * \pname{arg1} Packet received in error, shared and read-only.
    * \pname{arg2} SNIR of packet.
    */
   typedef Callback<void, Ptr<Packet>, double > RxErrCallback;
@@ -234,7 +257,8 @@ public:
   /**
    * Packet arriving from channel:  i.e.  leading bit of packet has arrived.
    *
-   * \param pkt Packet which is arriving.
+   * \param pkt Packet which is arriving, shared with the other receivers
+   *   and thus not to be modified.
    * \param rxPowerDb Signal power of incoming packet in dB re 1 uPa.
    * \param txMode Transmission mode defining modulation of incoming packet.
    * \param pdp Power delay profile of incoming packet.
@@ -378,6 +402,20 @@ public:
    */
   virtual void NotifyIntChange (void) = 0;
 
+  /**
+   * Called when an arrival on the attached transducer is over, once
+   * it has been removed from the arrival list.
+   *
+   * This ends the reception of the packet if it was being received,
+   * and accounts for the change in interference. The default
+   * implementation only calls NotifyIntChange.
+   *
+   * \param pkt The packet which has finished arriving.
+   * \param rxPowerDb Received power of the packet.
+   * \param txMode Transmission mode of the packet.
+   */
+  virtual void NotifyArrivalEnd (Ptr<Packet> pkt, double rxPowerDb, LoraTxMode txMode);
+
   /**
    * Attach a transducer to this Phy.
    *
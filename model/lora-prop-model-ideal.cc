@@ -21,6 +21,9 @@
 #include "lora-tx-mode.h"
 #include "ns3/mobility-model.h"
 
+#include <limits>
+#include <cmath>
+
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (LoraPropModelIdeal);
@@ -63,5 +66,49 @@ LoraPropModelIdeal::GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b, LoraTx
   return Seconds (a->GetDistanceFrom (b) / 1500.0);
 }
 
+bool
+LoraPropModelIdeal::SupportsPositions (void) const
+{
+  return true;
+}
+
+double
+LoraPropModelIdeal::GetPathLossDbFromPositions (const Vector &a, const Vector &b, LoraTxMode mode)
+{
+  return 0;
+}
+
+double
+LoraPropModelIdeal::GetDelaySecondsFromPositions (const Vector &a, const Vector &b, LoraTxMode mode)
+{
+  return CalculateDistance (a, b) / 1500.0;
+}
+
+void
+LoraPropModelIdeal::GetLinkBudgetsFromPositions (const Vector &sender,
+                                                 const double *x, const double *y, const double *z,
+                                                 uint32_t n, LoraTxMode mode,
+                                                 double *lossDb, double *delayS)
+{
+  const double sx = sender.x;
+  const double sy = sender.y;
+  const double sz = sender.z;
+  for (uint32_t k = 0; k < n; k++)
+    {
+      double dx = x[k] - sx;
+      double dy = y[k] - sy;
+      double dz = z[k] - sz;
+      lossDb[k] = 0;
+      delayS[k] = std::sqrt (dx * dx + dy * dy + dz * dz) / 1500.0;
+    }
+}
+
+double
+LoraPropModelIdeal::GetMaxRangeM (double maxLossDb, LoraTxMode mode)
+{
+  // No pathloss: either everybody hears the signal, or nobody does.
+  return (maxLossDb >= 0) ? std::numeric_limits<double>::infinity () : 0;
+}
+
 
 } // namespace ns3
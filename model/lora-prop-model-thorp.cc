@@ -21,6 +21,8 @@
 #include "ns3/double.h"
 #include "ns3/log.h"
 
+#include <limits>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("LoraPropModelThorp");
@@ -54,12 +56,86 @@ LoraPropModelThorp::GetTypeId (void)
 double
 LoraPropModelThorp::GetPathLossDb (Ptr<MobilityModel> a, Ptr<MobilityModel> b, LoraTxMode mode)
 {
-  double dist = a->GetDistanceFrom (b);
+  return GetPathLossDbFromPositions (a->GetPosition (), b->GetPosition (), mode);
+}
+
+bool
+LoraPropModelThorp::SupportsPositions (void) const
+{
+  return true;
+}
+
+double
+LoraPropModelThorp::GetPathLossDbFromPositions (const Vector &a, const Vector &b, LoraTxMode mode)
+{
+  double dist = CalculateDistance (a, b);
 
   return m_SpreadCoef * 10.0 * std::log10 (dist)
          + (dist / 1000.0) * GetAttenDbKm (mode.GetCenterFreqHz () / 1000.0);
 }
 
+double
+LoraPropModelThorp::GetDelaySecondsFromPositions (const Vector &a, const Vector &b, LoraTxMode mode)
+{
+  return CalculateDistance (a, b) / 1500.0;
+}
+
+void
+LoraPropModelThorp::GetLinkBudgetsFromPositions (const Vector &sender,
+                                                 const double *x, const double *y, const double *z,
+                                                 uint32_t n, LoraTxMode mode,
+                                                 double *lossDb, double *delayS)
+{
+  // Everything depending on the mode only is evaluated once.
+  const double spread = m_SpreadCoef * 10.0;
+  const double attenDbKm = GetAttenDbKm (mode.GetCenterFreqHz () / 1000.0);
+  const double sx = sender.x;
+  const double sy = sender.y;
+  const double sz = sender.z;
+  for (uint32_t k = 0; k < n; k++)
+    {
+      double dx = x[k] - sx;
+      double dy = y[k] - sy;
+      double dz = z[k] - sz;
+      double dist = std::sqrt (dx * dx + dy * dy + dz * dz);
+      lossDb[k] = spread * std::log10 (dist) + (dist / 1000.0) * attenDbKm;
+      delayS[k] = dist / 1500.0;
+    }
+}
+
+double
+LoraPropModelThorp::GetMaxRangeM (double maxLossDb, LoraTxMode mode)
+{
+  double attenDbKm = GetAttenDbKm (mode.GetCenterFreqHz () / 1000.0);
+
+  // The pathloss grows with distance, bracket the range then bisect.
+  double lo = 0;
+  double hi = 1.0;
+  while (m_SpreadCoef * 10.0 * std::log10 (hi) + (hi / 1000.0) * attenDbKm <= maxLossDb)
+    {
+      lo = hi;
+      hi *= 2;
+      if (hi > 1e9)
+        {
+          return std::numeric_limits<double>::infinity ();
+        }
+    }
+  for (uint32_t i = 0; i < 64 && (hi - lo) > 0.01; i++)
+    {
+      double mid = (lo + hi) / 2;
+      if (m_SpreadCoef * 10.0 * std::log10 (mid) + (mid / 1000.0) * attenDbKm <= maxLossDb)
+        {
+          lo = mid;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+  // Round up so that culling never drops a receiver the model would reach.
+  return hi;
+}
+
 LoraPdp
 LoraPropModelThorp::GetPdp (Ptr<MobilityModel> a, Ptr<MobilityModel> b, LoraTxMode mode)
 {
@@ -48,6 +48,14 @@ public:
   virtual double GetPathLossDb (Ptr<MobilityModel> a, Ptr<MobilityModel> b, LoraTxMode mode);
   virtual LoraPdp GetPdp (Ptr<MobilityModel> a, Ptr<MobilityModel> b, LoraTxMode mode);
   virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b, LoraTxMode mode);
+  virtual double GetMaxRangeM (double maxLossDb, LoraTxMode mode);
+  virtual bool SupportsPositions (void) const;
+  virtual double GetPathLossDbFromPositions (const Vector &a, const Vector &b, LoraTxMode mode);
+  virtual double GetDelaySecondsFromPositions (const Vector &a, const Vector &b, LoraTxMode mode);
+  virtual void GetLinkBudgetsFromPositions (const Vector &sender,
+                                            const double *x, const double *y, const double *z,
+                                            uint32_t n, LoraTxMode mode,
+                                            double *lossDb, double *delayS);
 
 private:
   /**
@@ -18,9 +18,11 @@
  */
 
 #include "lora-prop-model.h"
+#include "lora-tx-mode.h"
 #include "ns3/nstime.h"
 #include <complex>
 #include <vector>
+#include <limits>
 
 
 namespace ns3 {
@@ -31,8 +33,8 @@ operator<< (std::ostream &os, const LoraPdp &pdp)
   os << pdp.GetNTaps () << '|';
   os << pdp.GetResolution ().GetSeconds () << '|';
 
-  LoraPdp::Iterator it = pdp.m_taps.begin ();
-  for (; it != pdp.m_taps.end (); it++)
+  LoraPdp::Iterator it = pdp.GetBegin ();
+  for (; it != pdp.GetEnd (); it++)
     {
       os << (*it).GetAmp () << '|';
     }
@@ -58,11 +60,12 @@ operator>> (std::istream &is, LoraPdp &pdp)
       NS_FATAL_ERROR ("LoraPdp data corrupted at resolution");
       return is;
     }
-  pdp.m_resolution = Seconds (resolution);
+  Ptr<LoraPdp::TapData> data = Create<LoraPdp::TapData> ();
+  data->m_resolution = Seconds (resolution);
 
 
   std::complex<double> amp;
-  pdp.m_taps = std::vector<Tap> (ntaps);
+  data->m_taps = std::vector<Tap> (ntaps);
   for (uint32_t i = 0; i < ntaps && !is.eof (); i++)
     {
       is >> amp >> c1;
@@ -71,8 +74,10 @@ operator>> (std::istream &is, LoraPdp &pdp)
           NS_FATAL_ERROR ("LoraPdp data corrupted at tap " << i);
           return is;
         }
-      pdp.m_taps[i] = Tap (Seconds (resolution * i), amp);
+      data->m_taps[i] = Tap (Seconds (resolution * i), amp);
     }
+  data->Update ();
+  pdp.m_data = data;
   return is;
 
 }
@@ -104,175 +109,220 @@ Tap::GetDelay (void) const
 }
 
 
+void
+LoraPdp::TapData::Update (void)
+{
+  m_impulse = m_resolution <= Seconds (0)
+    && m_taps.size () == 1
+    && m_taps[0].GetAmp () == std::complex<double> (1.0);
+
+  uint32_t n = m_taps.size ();
+  double maxAmp = -1;
+  m_peak = 0;
+  m_ncSums.resize (n + 1);
+  m_cSums.resize (n + 1);
+  m_ncSums[0] = 0;
+  m_cSums[0] = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double amp = std::abs (m_taps[i].GetAmp ());
+      if (amp > maxAmp)
+        {
+          maxAmp = amp;
+          m_peak = i;
+        }
+      m_ncSums[i + 1] = m_ncSums[i] + amp;
+      m_cSums[i + 1] = m_cSums[i] + m_taps[i].GetAmp ();
+    }
+}
+
 LoraPdp::LoraPdp ()
 {
+  // All the empty PDPs share the same storage
+  static Ptr<TapData> empty;
+  if (!empty)
+    {
+      empty = Create<TapData> ();
+      empty->Update ();
+    }
+  m_data = empty;
+}
 
+LoraPdp::LoraPdp (Ptr<TapData> data)
+  : m_data (data)
+{
 }
 
 LoraPdp::LoraPdp (std::vector<Tap> taps, Time resolution)
-  : m_taps (taps),
-    m_resolution (resolution)
+  : m_data (Create<TapData> ())
 {
+  m_data->m_taps = taps;
+  m_data->m_resolution = resolution;
+  m_data->Update ();
 }
 
 LoraPdp::LoraPdp (std::vector<std::complex<double> > amps, Time resolution)
-  : m_resolution (resolution)
+  : m_data (Create<TapData> ())
 {
-  m_taps.resize (amps.size ());
+  m_data->m_resolution = resolution;
+  m_data->m_taps.resize (amps.size ());
   Time arrTime = Seconds (0);
   for (uint32_t index = 0; index < amps.size (); index++)
     {
-      m_taps[index] = Tap (arrTime, amps[index]);
-      arrTime = arrTime + m_resolution;
+      m_data->m_taps[index] = Tap (arrTime, amps[index]);
+      arrTime = arrTime + resolution;
     }
+  m_data->Update ();
 }
 
 LoraPdp::LoraPdp (std::vector<double> amps, Time resolution)
-  : m_resolution (resolution)
+  : m_data (Create<TapData> ())
 {
-  m_taps.resize (amps.size ());
+  m_data->m_resolution = resolution;
+  m_data->m_taps.resize (amps.size ());
   Time arrTime = Seconds (0);
   for (uint32_t index = 0; index < amps.size (); index++)
     {
-      m_taps[index] = Tap (arrTime, amps[index]);
-      arrTime = arrTime + m_resolution;
+      m_data->m_taps[index] = Tap (arrTime, amps[index]);
+      arrTime = arrTime + resolution;
     }
+  m_data->Update ();
 }
 
 LoraPdp::~LoraPdp ()
 {
-  m_taps.clear ();
+}
+
+LoraPdp::TapData &
+LoraPdp::GetWritable (void)
+{
+  if (m_data->GetReferenceCount () > 1)
+    {
+      m_data = Create<TapData> (*m_data);
+    }
+  return *m_data;
+}
+
+bool
+LoraPdp::IsImpulse (void) const
+{
+  return m_data->m_impulse;
+}
+
+uint32_t
+LoraPdp::GetPeakTapIndex (void) const
+{
+  return m_data->m_peak;
 }
 
 void
 LoraPdp::SetTap (std::complex<double> amp, uint32_t index)
 {
-  if (m_taps.size () <= index)
+  TapData &data = GetWritable ();
+  if (data.m_taps.size () <= index)
     {
-      m_taps.resize (index + 1);
+      data.m_taps.resize (index + 1);
     }
 
-  Time delay = Seconds (index * m_resolution.GetSeconds ());
-  m_taps[index] = Tap (delay, amp);
+  Time delay = Seconds (index * data.m_resolution.GetSeconds ());
+  data.m_taps[index] = Tap (delay, amp);
+  data.Update ();
 }
 const Tap &
 LoraPdp::GetTap (uint32_t i) const
 {
   NS_ASSERT_MSG (i < GetNTaps (), "Call to LoraPdp::GetTap with requested tap out of range");
-  return m_taps[i];
+  return m_data->m_taps[i];
 }
 void
 LoraPdp::SetNTaps (uint32_t nTaps)
 {
-  m_taps.resize (nTaps);
+  TapData &data = GetWritable ();
+  data.m_taps.resize (nTaps);
+  data.Update ();
 }
 void
 LoraPdp::SetResolution (Time resolution)
 {
-  m_resolution = resolution;
+  TapData &data = GetWritable ();
+  data.m_resolution = resolution;
+  data.Update ();
 }
 LoraPdp::Iterator
 LoraPdp::GetBegin (void) const
 {
-  return m_taps.begin ();
+  return m_data->m_taps.begin ();
 }
 
 LoraPdp::Iterator
 LoraPdp::GetEnd (void) const
 {
-  return m_taps.end ();
+  return m_data->m_taps.end ();
 }
 
 uint32_t
 LoraPdp::GetNTaps (void) const
 {
-  return m_taps.size ();
+  return m_data->m_taps.size ();
 }
 
 Time
 LoraPdp::GetResolution (void) const
 {
-  return m_resolution;
+  return m_data->m_resolution;
 }
 
 std::complex<double>
 LoraPdp::SumTapsFromMaxC (Time delay, Time duration) const
 {
-  if (m_resolution <= Seconds (0))
+  if (m_data->m_resolution <= Seconds (0))
     {
       NS_ASSERT_MSG (GetNTaps () == 1, "Attempted to sum taps over time interval in "
                      "LoraPdp with resolution 0 and multiple taps");
 
-      return m_taps[0].GetAmp ();
+      return m_data->m_taps[0].GetAmp ();
     }
 
-  uint32_t numTaps =  static_cast<uint32_t> (duration.GetSeconds () / m_resolution.GetSeconds () + 0.5);
-  double maxAmp = -1;
-  uint32_t maxTapIndex = 0;
-
-  for (uint32_t i = 0; i < GetNTaps (); i++)
-    {
-      if (std::abs (m_taps[i].GetAmp ()) > maxAmp)
-        {
-          maxAmp = std::abs (m_taps[i].GetAmp ());
-          maxTapIndex = i;
-        }
-    }
-  uint32_t start = maxTapIndex + static_cast<uint32_t> (delay.GetSeconds () / m_resolution.GetSeconds ());
+  uint32_t numTaps =  static_cast<uint32_t> (duration.GetSeconds () / m_data->m_resolution.GetSeconds () + 0.5);
+  uint32_t start = m_data->m_peak + static_cast<uint32_t> (delay.GetSeconds () / m_data->m_resolution.GetSeconds ());
   uint32_t end = std::min (start + numTaps, GetNTaps ());
-  std::complex<double> sum = 0;
-  for (uint32_t i = start; i < end; i++)
+  if (start >= end)
     {
-      sum += m_taps[i].GetAmp ();
+      return std::complex<double> (0.0);
     }
-  return sum;
+  return m_data->m_cSums[end] - m_data->m_cSums[start];
 }
 double
 LoraPdp::SumTapsFromMaxNc (Time delay, Time duration) const
 {
-  if (m_resolution <= Seconds (0))
+  if (m_data->m_resolution <= Seconds (0))
     {
       NS_ASSERT_MSG (GetNTaps () == 1, "Attempted to sum taps over time interval in "
                      "LoraPdp with resolution 0 and multiple taps");
 
-      return std::abs (m_taps[0].GetAmp ());
-    }
-
-  uint32_t numTaps =  static_cast<uint32_t> (duration.GetSeconds () / m_resolution.GetSeconds () + 0.5);
-  double maxAmp = -1;
-  uint32_t maxTapIndex = 0;
-
-  for (uint32_t i = 0; i < GetNTaps (); i++)
-    {
-      if (std::abs (m_taps[i].GetAmp ()) > maxAmp)
-        {
-          maxAmp = std::abs (m_taps[i].GetAmp ());
-          maxTapIndex = i;
-        }
+      return std::abs (m_data->m_taps[0].GetAmp ());
     }
 
-
-  uint32_t start = maxTapIndex + static_cast<uint32_t> (delay.GetSeconds () / m_resolution.GetSeconds ());
+  uint32_t numTaps =  static_cast<uint32_t> (duration.GetSeconds () / m_data->m_resolution.GetSeconds () + 0.5);
+  uint32_t start = m_data->m_peak + static_cast<uint32_t> (delay.GetSeconds () / m_data->m_resolution.GetSeconds ());
   uint32_t end = std::min (start + numTaps, GetNTaps ());
-  double sum = 0;
-  for (uint32_t i = start; i < end; i++)
-
+  if (start >= end)
     {
-      sum += std::abs (m_taps[i].GetAmp ());
+      return 0.0;
     }
-  return sum;
+  return m_data->m_ncSums[end] - m_data->m_ncSums[start];
 }
 double
-LoraPdp::SumTapsNc (Time begin, Time end) const
+LoraPdp::SumTapsNc (Time begin, Time endTime) const
 {
-  if (m_resolution <= Seconds (0))
+  if (m_data->m_resolution <= Seconds (0))
     {
       NS_ASSERT_MSG (GetNTaps () == 1, "Attempted to sum taps over time interval in "
                      "LoraPdp with resolution 0 and multiple taps");
 
-      if (begin <= Seconds (0.0) && end >= Seconds (0.0))
+      if (begin <= Seconds (0.0) && endTime >= Seconds (0.0))
         {
-          return std::abs (m_taps[0].GetAmp ());
+          return std::abs (m_data->m_taps[0].GetAmp ());
         }
       else
         {
@@ -280,32 +330,26 @@ LoraPdp::SumTapsNc (Time begin, Time end) const
         }
     }
 
-  uint32_t stIndex = (uint32_t)(begin.GetSeconds () / m_resolution.GetSeconds () + 0.5);
-  uint32_t endIndex = (uint32_t)(end.GetSeconds () / m_resolution.GetSeconds () + 0.5);
-
-  endIndex = std::min (endIndex, GetNTaps ());
-  double sum = 0;
-  for (uint32_t i = stIndex; i < endIndex; i++)
+  uint32_t start = (uint32_t)(begin.GetSeconds () / m_data->m_resolution.GetSeconds () + 0.5);
+  uint32_t end = std::min ((uint32_t)(endTime.GetSeconds () / m_data->m_resolution.GetSeconds () + 0.5), GetNTaps ());
+  if (start >= end)
     {
-      sum += std::abs (m_taps[i].GetAmp ());
+      return 0.0;
     }
-  return sum;
-
+  return m_data->m_ncSums[end] - m_data->m_ncSums[start];
 }
 
-
-
 std::complex<double>
-LoraPdp::SumTapsC (Time begin, Time end) const
+LoraPdp::SumTapsC (Time begin, Time endTime) const
 {
-  if (m_resolution <= Seconds (0))
+  if (m_data->m_resolution <= Seconds (0))
     {
       NS_ASSERT_MSG (GetNTaps () == 1, "Attempted to sum taps over time interval in "
                      "LoraPdp with resolution 0 and multiple taps");
 
-      if (begin <= Seconds (0.0) && end >= Seconds (0.0))
+      if (begin <= Seconds (0.0) && endTime >= Seconds (0.0))
         {
-          return m_taps[0].GetAmp ();
+          return m_data->m_taps[0].GetAmp ();
         }
       else
         {
@@ -313,26 +357,27 @@ LoraPdp::SumTapsC (Time begin, Time end) const
         }
     }
 
-  uint32_t stIndex = (uint32_t)(begin.GetSeconds () / m_resolution.GetSeconds () + 0.5);
-  uint32_t endIndex = (uint32_t)(end.GetSeconds () / m_resolution.GetSeconds () + 0.5);
-
-  endIndex = std::min (endIndex, GetNTaps ());
-
-  std::complex<double> sum = 0;
-  for (uint32_t i = stIndex; i < endIndex; i++)
+  uint32_t start = (uint32_t)(begin.GetSeconds () / m_data->m_resolution.GetSeconds () + 0.5);
+  uint32_t end = std::min ((uint32_t)(endTime.GetSeconds () / m_data->m_resolution.GetSeconds () + 0.5), GetNTaps ());
+  if (start >= end)
     {
-      sum += m_taps[i].GetAmp ();
+      return std::complex<double> (0.0);
     }
-  return sum;
+  return m_data->m_cSums[end] - m_data->m_cSums[start];
 }
 
 LoraPdp
 LoraPdp::CreateImpulsePdp (void)
 {
-  LoraPdp pdp;
-  pdp.SetResolution (Seconds (0));
-  pdp.SetTap (1.0,0);
-  return pdp;
+  static Ptr<TapData> impulse;
+  if (!impulse)
+    {
+      impulse = Create<TapData> ();
+      impulse->m_taps.push_back (Tap (Seconds (0), 1.0));
+      impulse->m_resolution = Seconds (0);
+      impulse->Update ();
+    }
+  return LoraPdp (impulse);
 }
 
 NS_OBJECT_ENSURE_REGISTERED (LoraPropModel);
@@ -346,6 +391,46 @@ TypeId LoraPropModel::GetTypeId (void)
   return tid;
 }
 
+double
+LoraPropModel::GetMaxRangeM (double maxLossDb, LoraTxMode mode)
+{
+  return std::numeric_limits<double>::infinity ();
+}
+
+bool
+LoraPropModel::SupportsPositions (void) const
+{
+  return false;
+}
+
+double
+LoraPropModel::GetPathLossDbFromPositions (const Vector &a, const Vector &b, LoraTxMode mode)
+{
+  NS_FATAL_ERROR ("Propagation model cannot be evaluated from positions");
+  return 0;
+}
+
+double
+LoraPropModel::GetDelaySecondsFromPositions (const Vector &a, const Vector &b, LoraTxMode mode)
+{
+  NS_FATAL_ERROR ("Propagation model cannot be evaluated from positions");
+  return 0;
+}
+
+void
+LoraPropModel::GetLinkBudgetsFromPositions (const Vector &sender,
+                                            const double *x, const double *y, const double *z,
+                                            uint32_t n, LoraTxMode mode,
+                                            double *lossDb, double *delayS)
+{
+  for (uint32_t k = 0; k < n; k++)
+    {
+      Vector rcvr (x[k], y[k], z[k]);
+      lossDb[k] = GetPathLossDbFromPositions (sender, rcvr, mode);
+      delayS[k] = GetDelaySecondsFromPositions (sender, rcvr, mode);
+    }
+}
+
 void
 LoraPropModel::Clear (void)
 {
@@ -23,6 +23,8 @@
 #include "ns3/object.h"
 #include "ns3/mobility-model.h"
 #include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
 
 
 #include <vector>
@@ -74,6 +76,9 @@ private:
  *
  * The power delay profile returned by propagation models.
  *
+ * A LoraPdp is a cheap handle to tap storage shared between copies,
+ * which is copied only when a shared profile is modified.
+ *
  * Generally, the profile should be normalized, such that
  * the sum of all taps should equal 1.  The received signal
  * power on any interval (t1, t2) can then be found from
@@ -115,6 +120,21 @@ public:
   /** Dummy destructor, see DoDispose. */
   ~LoraPdp ();
 
+  /**
+   * Check for the unit impulse at time 0, as built by CreateImpulsePdp.
+   *
+   * SINR calculators may skip tap arithmetic for such profiles.
+   *
+   * \return True if this PDP is the unit impulse.
+   */
+  bool IsImpulse (void) const;
+  /**
+   * Get the index of the maximum amplitude tap (the first one, on ties).
+   *
+   * \return Index of the peak tap, 0 if there is no tap.
+   */
+  uint32_t GetPeakTapIndex (void) const;
+
   /**
    * Set the arrival value for a tap.
    *
@@ -229,6 +249,8 @@ public:
   /**
    * Get a unit impulse PDP at time 0.
    *
+   * All the impulse PDPs share the same tap storage.
+   *
    * \return The unit impulse.
    */ 
   static LoraPdp CreateImpulsePdp (void);
@@ -236,9 +258,46 @@ public:
 private:
   friend std::ostream &operator<< (std::ostream &os, const LoraPdp &pdp);
   friend std::istream &operator>> (std::istream &is, LoraPdp &pdp);
-  
-  std::vector<Tap> m_taps;  //!< The vector of Taps.
-  Time m_resolution;        //!< The time resolution.
+
+  /**
+   * Tap storage, shared by the copies of a LoraPdp.
+   */
+  struct TapData : public SimpleRefCount<TapData>
+  {
+    /**
+     * Update the cached values after the taps or resolution changed.
+     *
+     * The peak tap and the prefix sums are computed here, by the owner
+     * of the storage, so that the const accessors never write to data
+     * that may be shared with other PDPs and read concurrently.
+     */
+    void Update (void);
+
+    std::vector<Tap> m_taps;  //!< The vector of Taps.
+    Time m_resolution;        //!< The time resolution.
+    bool m_impulse;           //!< This is the unit impulse at time 0.
+    uint32_t m_peak;          //!< Index of the first maximum amplitude tap.
+    /** Sum of the amplitude magnitudes of the taps before each index. */
+    std::vector<double> m_ncSums;
+    /** Sum of the complex amplitudes of the taps before each index. */
+    std::vector<std::complex<double> > m_cSums;
+  };
+
+  /**
+   * Create a PDP using existing tap storage.
+   *
+   * \param data The tap storage.
+   */
+  LoraPdp (Ptr<TapData> data);
+  /**
+   * Get the tap storage for modification, copying it first if it is
+   * shared with other PDPs.
+   *
+   * \return The tap storage owned by this PDP.
+   */
+  TapData &GetWritable (void);
+
+  Ptr<TapData> m_data;  //!< The shared tap storage.
 
 };  // class LoraPdp
 
@@ -304,6 +363,72 @@ public:
    */
   virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b, LoraTxMode mode) = 0;
 
+  /**
+   * Get the largest distance at which the pathloss does not exceed a bound.
+   *
+   * Used by LoraChannel to cull receivers that cannot hear a transmission
+   * above the interference floor.  Models without a monotonic distance
+   * dependency should keep the default, which disables culling.
+   *
+   * \param maxLossDb The largest acceptable pathloss in dB.
+   * \param mode TX mode of transmission.
+   * \return Range in meters, or infinity if no bound is known.
+   */
+  virtual double GetMaxRangeM (double maxLossDb, LoraTxMode mode);
+
+  /**
+   * Whether GetPathLossDbFromPositions and GetDelaySecondsFromPositions
+   * are implemented, giving the same results as GetPathLossDb and
+   * GetDelay. They must then be safe to call from several threads at
+   * once, without touching the simulator nor any shared Ptr.
+   *
+   * \return True if the model can be evaluated from positions only.
+   */
+  virtual bool SupportsPositions (void) const;
+
+  /**
+   * Computes pathloss between two positions.
+   *
+   * \param a Position of node a.
+   * \param b Position of node b.
+   * \param mode TX mode of transmission between a and b.
+   * \return Pathloss in dB.
+   */
+  virtual double GetPathLossDbFromPositions (const Vector &a, const Vector &b, LoraTxMode mode);
+
+  /**
+   * Finds propagation delay between two positions.
+   *
+   * \param a Position of node a.
+   * \param b Position of node b.
+   * \param mode TX mode of transmission.
+   * \return Propagation delay in seconds.
+   */
+  virtual double GetDelaySecondsFromPositions (const Vector &a, const Vector &b, LoraTxMode mode);
+
+  /**
+   * Computes pathloss and delay from one transmitter to many receivers.
+   *
+   * Receiver positions are given as structure of arrays, so that
+   * implementations can run a single loop the compiler may vectorize.
+   * The default implementation calls GetPathLossDbFromPositions and
+   * GetDelaySecondsFromPositions for each receiver, and requires
+   * SupportsPositions.
+   *
+   * \param sender Position of the transmitter.
+   * \param x X coordinates of the receivers.
+   * \param y Y coordinates of the receivers.
+   * \param z Z coordinates of the receivers.
+   * \param n Number of receivers.
+   * \param mode TX mode of transmission.
+   * \param lossDb Filled with the pathloss in dB to each receiver.
+   * \param delayS Filled with the delay in seconds to each receiver.
+   */
+  virtual void GetLinkBudgetsFromPositions (const Vector &sender,
+                                            const double *x, const double *y, const double *z,
+                                            uint32_t n, LoraTxMode mode,
+                                            double *lossDb, double *delayS);
+
   /** Clear all pointer references. */
   virtual void Clear (void);
 
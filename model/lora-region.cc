@@ -0,0 +1,306 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lora-region.h"
+#include "ns3/log.h"
+
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LoraRegion");
+
+/*
+ * Parameters from the LoRaWAN regional parameters (RP002-1.0.x).
+ * Only the default channels are listed; the FSK data rates are left
+ * out and their DR slots hold a 0 spreading factor.  The tables are
+ * constant expressions, so they are built at compile time with no
+ * static initialization order to care about.
+ */
+
+static constexpr LoraRegion::DataRate g_eu868DataRates[] = {
+  { 12, 125000, 59 },
+  { 11, 125000, 59 },
+  { 10, 125000, 59 },
+  { 9, 125000, 123 },
+  { 8, 125000, 230 },
+  { 7, 125000, 230 },
+  { 7, 250000, 230 },
+};
+
+static constexpr LoraRegion::Channel g_eu868Channels[] = {
+  { 868100000, 0, 5 }, { 868300000, 0, 5 }, { 868500000, 0, 5 },
+};
+
+static constexpr LoraRegion::SubBand g_eu868SubBands[] = {
+  { 863000000, 865000000, 0.001, 14 },
+  { 865000000, 868000000, 0.01, 14 },
+  { 868000000, 868600000, 0.01, 14 },
+  { 868700000, 869200000, 0.001, 14 },
+  { 869400000, 869650000, 0.1, 27 },
+  { 869700000, 870000000, 0.01, 14 },
+};
+
+static constexpr LoraRegion::DataRate g_us915DataRates[] = {
+  { 10, 125000, 19 },
+  { 9, 125000, 61 },
+  { 8, 125000, 133 },
+  { 7, 125000, 250 },
+  { 8, 500000, 250 },
+  { 0, 0, 0 },
+  { 0, 0, 0 },
+  { 0, 0, 0 },
+  { 12, 500000, 61 },
+  { 11, 500000, 137 },
+  { 10, 500000, 250 },
+  { 9, 500000, 250 },
+  { 8, 500000, 250 },
+  { 7, 500000, 250 },
+};
+
+/* 64 + 8 uplink channels, then the 8 downlink channels */
+static constexpr LoraRegion::Channel g_us915Channels[] = {
+  { 902300000, 0, 3 }, { 902500000, 0, 3 }, { 902700000, 0, 3 },
+  { 902900000, 0, 3 }, { 903100000, 0, 3 }, { 903300000, 0, 3 },
+  { 903500000, 0, 3 }, { 903700000, 0, 3 }, { 903900000, 0, 3 },
+  { 904100000, 0, 3 }, { 904300000, 0, 3 }, { 904500000, 0, 3 },
+  { 904700000, 0, 3 }, { 904900000, 0, 3 }, { 905100000, 0, 3 },
+  { 905300000, 0, 3 }, { 905500000, 0, 3 }, { 905700000, 0, 3 },
+  { 905900000, 0, 3 }, { 906100000, 0, 3 }, { 906300000, 0, 3 },
+  { 906500000, 0, 3 }, { 906700000, 0, 3 }, { 906900000, 0, 3 },
+  { 907100000, 0, 3 }, { 907300000, 0, 3 }, { 907500000, 0, 3 },
+  { 907700000, 0, 3 }, { 907900000, 0, 3 }, { 908100000, 0, 3 },
+  { 908300000, 0, 3 }, { 908500000, 0, 3 }, { 908700000, 0, 3 },
+  { 908900000, 0, 3 }, { 909100000, 0, 3 }, { 909300000, 0, 3 },
+  { 909500000, 0, 3 }, { 909700000, 0, 3 }, { 909900000, 0, 3 },
+  { 910100000, 0, 3 }, { 910300000, 0, 3 }, { 910500000, 0, 3 },
+  { 910700000, 0, 3 }, { 910900000, 0, 3 }, { 911100000, 0, 3 },
+  { 911300000, 0, 3 }, { 911500000, 0, 3 }, { 911700000, 0, 3 },
+  { 911900000, 0, 3 }, { 912100000, 0, 3 }, { 912300000, 0, 3 },
+  { 912500000, 0, 3 }, { 912700000, 0, 3 }, { 912900000, 0, 3 },
+  { 913100000, 0, 3 }, { 913300000, 0, 3 }, { 913500000, 0, 3 },
+  { 913700000, 0, 3 }, { 913900000, 0, 3 }, { 914100000, 0, 3 },
+  { 914300000, 0, 3 }, { 914500000, 0, 3 }, { 914700000, 0, 3 },
+  { 914900000, 0, 3 }, { 903000000, 4, 4 }, { 904600000, 4, 4 },
+  { 906200000, 4, 4 }, { 907800000, 4, 4 }, { 909400000, 4, 4 },
+  { 911000000, 4, 4 }, { 912600000, 4, 4 }, { 914200000, 4, 4 },
+  { 923300000, 8, 13 }, { 923900000, 8, 13 }, { 924500000, 8, 13 },
+  { 925100000, 8, 13 }, { 925700000, 8, 13 }, { 926300000, 8, 13 },
+  { 926900000, 8, 13 }, { 927500000, 8, 13 },
+};
+
+static constexpr LoraRegion::SubBand g_us915SubBands[] = {
+  { 902000000, 928000000, 1.0, 30 },
+};
+
+static constexpr LoraRegion::DataRate g_as923DataRates[] = {
+  { 12, 125000, 59 },
+  { 11, 125000, 59 },
+  { 10, 125000, 59 },
+  { 9, 125000, 123 },
+  { 8, 125000, 230 },
+  { 7, 125000, 230 },
+  { 7, 250000, 230 },
+};
+
+static constexpr LoraRegion::Channel g_as923Channels[] = {
+  { 923200000, 0, 5 }, { 923400000, 0, 5 },
+};
+
+static constexpr LoraRegion::SubBand g_as923SubBands[] = {
+  { 915000000, 928000000, 0.01, 16 },
+};
+
+#define LORA_REGION_COUNT(a) (sizeof (a) / sizeof (a[0]))
+
+static_assert (LORA_REGION_COUNT (g_us915Channels) == 80, "US915 needs 72 uplink and 8 downlink channels");
+static_assert (LORA_REGION_COUNT (g_us915DataRates) == 14, "US915 needs DR0 to DR13");
+
+static constexpr LoraRegion::Plan g_plans[] = {
+  { "EU868",
+    g_eu868Channels, LORA_REGION_COUNT (g_eu868Channels),
+    g_eu868DataRates, LORA_REGION_COUNT (g_eu868DataRates),
+    g_eu868SubBands, LORA_REGION_COUNT (g_eu868SubBands),
+    869525000, 0, 8, 1 },
+  { "US915",
+    g_us915Channels, LORA_REGION_COUNT (g_us915Channels),
+    g_us915DataRates, LORA_REGION_COUNT (g_us915DataRates),
+    g_us915SubBands, LORA_REGION_COUNT (g_us915SubBands),
+    923300000, 8, 8, 1 },
+  { "AS923",
+    g_as923Channels, LORA_REGION_COUNT (g_as923Channels),
+    g_as923DataRates, LORA_REGION_COUNT (g_as923DataRates),
+    g_as923SubBands, LORA_REGION_COUNT (g_as923SubBands),
+    923200000, 2, 8, 1 },
+};
+
+const uint32_t LoraRegion::NO_MODE;
+
+/**
+ * Check if LoRa mandates low data rate optimization for a data rate,
+ * that is for symbols of 16 ms or more.
+ *
+ * \param rate The data rate.
+ * \return True if low data rate optimization is needed.
+ */
+static bool
+NeedsLowDataRateOpt (const LoraRegion::DataRate &rate)
+{
+  return (1000.0 * (1 << rate.m_sf)) / rate.m_bwHz >= 16.0;
+}
+
+const LoraRegion::Plan &
+LoraRegion::GetPlan (Region region)
+{
+  NS_ASSERT ((uint32_t) region < LORA_REGION_COUNT (g_plans));
+  return g_plans[region];
+}
+
+const std::vector<uint32_t> &
+LoraRegion::GetModeUids (Region region)
+{
+  static std::vector<uint32_t> uids[LORA_REGION_COUNT (g_plans)];
+  std::vector<uint32_t> &table = uids[region];
+  if (!table.empty ())
+    {
+      return table;
+    }
+
+  const Plan &plan = GetPlan (region);
+  table.resize (plan.m_nChannels * plan.m_nDataRates, NO_MODE);
+  for (uint32_t c = 0; c < plan.m_nChannels; c++)
+    {
+      const Channel &channel = plan.m_channels[c];
+      for (uint32_t dr = channel.m_minDr; dr <= channel.m_maxDr; dr++)
+        {
+          const DataRate &rate = plan.m_dataRates[dr];
+          if (rate.m_sf == 0)
+            {
+              continue;
+            }
+          std::ostringstream name;
+          name << plan.m_name << "-" << channel.m_freqHz << "-DR" << dr;
+          LoraTxMode mode = LoraTxModeFactory::CreateLoraMode (rate.m_sf, rate.m_bwHz,
+                                                               plan.m_codingRate,
+                                                               channel.m_freqHz,
+                                                               plan.m_preambleLength,
+                                                               true, NeedsLowDataRateOpt (rate),
+                                                               name.str ());
+          table[c * plan.m_nDataRates + dr] = mode.GetUid ();
+        }
+    }
+  return table;
+}
+
+LoraTxMode
+LoraRegion::GetMode (Region region, uint32_t channel, uint32_t dr)
+{
+  const Plan &plan = GetPlan (region);
+  if (channel >= plan.m_nChannels || dr >= plan.m_nDataRates)
+    {
+      NS_FATAL_ERROR ("No channel " << channel << " or DR" << dr << " in " << plan.m_name);
+    }
+  uint32_t uid = GetModeUids (region)[channel * plan.m_nDataRates + dr];
+  if (uid == NO_MODE)
+    {
+      NS_FATAL_ERROR ("Channel " << channel << " of " << plan.m_name << " does not allow DR" << dr);
+    }
+  return LoraTxModeFactory::GetMode (uid);
+}
+
+LoraTxMode
+LoraRegion::GetRx2Mode (Region region)
+{
+  const Plan &plan = GetPlan (region);
+  for (uint32_t c = 0; c < plan.m_nChannels; c++)
+    {
+      const Channel &channel = plan.m_channels[c];
+      if (channel.m_freqHz == plan.m_rx2FreqHz
+          && plan.m_rx2Dr >= channel.m_minDr && plan.m_rx2Dr <= channel.m_maxDr)
+        {
+          return GetMode (region, c, plan.m_rx2Dr);
+        }
+    }
+
+  // RX2 is off the default channels, register it on its own
+  static LoraTxMode modes[LORA_REGION_COUNT (g_plans)];
+  static bool created[LORA_REGION_COUNT (g_plans)] = { false };
+  if (!created[region])
+    {
+      const DataRate &rate = plan.m_dataRates[plan.m_rx2Dr];
+      std::ostringstream name;
+      name << plan.m_name << "-RX2";
+      modes[region] = LoraTxModeFactory::CreateLoraMode (rate.m_sf, rate.m_bwHz,
+                                                         plan.m_codingRate,
+                                                         plan.m_rx2FreqHz,
+                                                         plan.m_preambleLength,
+                                                         true, NeedsLowDataRateOpt (rate),
+                                                         name.str ());
+      created[region] = true;
+    }
+  return modes[region];
+}
+
+LoraModesList
+LoraRegion::GetModes (Region region)
+{
+  const Plan &plan = GetPlan (region);
+  const std::vector<uint32_t> &uids = GetModeUids (region);
+  LoraModesList list;
+  for (uint32_t i = 0; i < uids.size (); i++)
+    {
+      if (uids[i] != NO_MODE)
+        {
+          list.AppendMode (LoraTxModeFactory::GetMode (uids[i]));
+        }
+    }
+  NS_LOG_DEBUG (plan.m_name << ": " << list.GetNModes () << " modes");
+  return list;
+}
+
+LoraModesList
+LoraRegion::GetModes (Region region, uint32_t dr)
+{
+  const Plan &plan = GetPlan (region);
+  NS_ASSERT (dr < plan.m_nDataRates);
+  const std::vector<uint32_t> &uids = GetModeUids (region);
+  LoraModesList list;
+  for (uint32_t c = 0; c < plan.m_nChannels; c++)
+    {
+      uint32_t uid = uids[c * plan.m_nDataRates + dr];
+      if (uid != NO_MODE)
+        {
+          list.AppendMode (LoraTxModeFactory::GetMode (uid));
+        }
+    }
+  return list;
+}
+
+const LoraRegion::SubBand *
+LoraRegion::GetSubBand (Region region, uint32_t freqHz)
+{
+  const Plan &plan = GetPlan (region);
+  for (uint32_t i = 0; i < plan.m_nSubBands; i++)
+    {
+      if (freqHz >= plan.m_subBands[i].m_minHz && freqHz < plan.m_subBands[i].m_maxHz)
+        {
+          return &plan.m_subBands[i];
+        }
+    }
+  return 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LORA_REGION_H
+#define LORA_REGION_H
+
+#include "lora-tx-mode.h"
+
+namespace ns3 {
+
+/**
+ *
+ * Built-in LoRaWAN regional channel plans.
+ *
+ * The plans are constant tables of the default channels, of the
+ * data rate (DR) index to spreading factor and bandwidth mapping, of
+ * the duty cycle sub-bands and of the RX2 defaults. The LoRa modes of
+ * a plan are registered once with LoraTxModeFactory, on first use,
+ * then retrieved by array indexing.
+ */
+class LoraRegion
+{
+public:
+  /**
+   * Supported regions.
+   */
+  typedef enum {
+    EU868,  //!< Europe 863-870 MHz.
+    US915,  //!< United States 902-928 MHz.
+    AS923   //!< Asia 923 MHz, without dwell time limits.
+  } Region;
+
+  /**
+   * Data rate index entry.
+   */
+  struct DataRate
+  {
+    uint32_t m_sf;          //!< Spreading factor, 0 for a DR not defined for LoRa.
+    uint32_t m_bwHz;        //!< Bandwidth in Hz.
+    uint32_t m_maxPayload;  //!< Maximum MAC payload size (M), in bytes.
+  };
+
+  /**
+   * Channel entry.
+   */
+  struct Channel
+  {
+    uint32_t m_freqHz;  //!< Center frequency in Hz.
+    uint32_t m_minDr;   //!< Lowest data rate index allowed.
+    uint32_t m_maxDr;   //!< Highest data rate index allowed.
+  };
+
+  /**
+   * Regulatory sub-band entry.
+   */
+  struct SubBand
+  {
+    uint32_t m_minHz;      //!< Lower edge, in Hz.
+    uint32_t m_maxHz;      //!< Upper edge, in Hz, excluded.
+    double m_dutyCycle;    //!< Maximum duty cycle, 1 for none.
+    double m_maxEirpDbm;   //!< Maximum EIRP, in dBm.
+  };
+
+  /**
+   * Regional channel plan.
+   */
+  struct Plan
+  {
+    const char *m_name;           //!< Region name.
+    const Channel *m_channels;    //!< Default channels.
+    uint32_t m_nChannels;         //!< Number of default channels.
+    const DataRate *m_dataRates;  //!< Data rates, indexed by DR.
+    uint32_t m_nDataRates;        //!< Number of DR indexes.
+    const SubBand *m_subBands;    //!< Regulatory sub-bands.
+    uint32_t m_nSubBands;         //!< Number of sub-bands.
+    uint32_t m_rx2FreqHz;         //!< RX2 default frequency, in Hz.
+    uint32_t m_rx2Dr;             //!< RX2 default data rate index.
+    uint32_t m_preambleLength;    //!< Preamble length, in symbols.
+    uint32_t m_codingRate;        //!< Coding rate index (1 for 4/5).
+  };
+
+  /**
+   * Get the channel plan of a region.
+   *
+   * \param region The region.
+   * \return The plan.
+   */
+  static const Plan &GetPlan (Region region);
+
+  /**
+   * Get the mode of a default channel at a data rate.
+   *
+   * \param region The region.
+   * \param channel Index of the channel in the plan.
+   * \param dr Data rate index, which the channel must allow.
+   * \return The mode.
+   */
+  static LoraTxMode GetMode (Region region, uint32_t channel, uint32_t dr);
+  /**
+   * Get the RX2 default mode.
+   *
+   * \param region The region.
+   * \return The mode.
+   */
+  static LoraTxMode GetRx2Mode (Region region);
+
+  /**
+   * Get the modes of all the default channels at all their data rates,
+   * channel by channel.
+   *
+   * \param region The region.
+   * \return The modes.
+   */
+  static LoraModesList GetModes (Region region);
+  /**
+   * Get the modes of the default channels which allow a data rate.
+   *
+   * \param region The region.
+   * \param dr Data rate index.
+   * \return The modes.
+   */
+  static LoraModesList GetModes (Region region, uint32_t dr);
+
+  /**
+   * Get the sub-band a frequency belongs to.
+   *
+   * Sub-bands include their lower edge but not their upper edge, so a
+   * frequency on the boundary of two adjacent sub-bands belongs to the
+   * upper one.
+   *
+   * \param region The region.
+   * \param freqHz Frequency, in Hz.
+   * \return The sub-band, or 0 if the frequency is in none.
+   */
+  static const SubBand *GetSubBand (Region region, uint32_t freqHz);
+
+private:
+  /**
+   * Get the uids of the modes of a region, registering them on the
+   * first call.
+   *
+   * \param region The region.
+   * \return Mode uids, indexed by channel * number of DRs + DR, or
+   *         LoraRegion::NO_MODE.
+   */
+  static const std::vector<uint32_t> &GetModeUids (Region region);
+
+  /** Marks a channel and DR pair with no mode. */
+  static const uint32_t NO_MODE = 0xffffffff;
+
+};  // class LoraRegion
+
+} // namespace ns3
+
+#endif /* LORA_REGION_H */
@@ -36,7 +36,8 @@ LoraTransducerHd::LoraTransducerHd ()
   : LoraTransducer (),
     m_state (RX),
     m_endTxTime (Seconds (0)),
-    m_cleared (false)
+    m_cleared (false),
+    m_nextArrivalId (0)
 {
 }
 
@@ -74,7 +75,15 @@ LoraTransducerHd::Clear ()
     }
   m_phyList.clear ();
   m_arrivalList.clear ();
-  m_endTxEvent.Cancel ();
+  m_arrivalIndex.clear ();
+  ClearArrivalPower ();
+  // The phys are gone: no end of transmission may reach them.
+  std::deque<EventId>::iterator eit = m_endTxEvents.begin ();
+  for (; eit != m_endTxEvents.end (); eit++)
+    {
+      eit->Cancel ();
+    }
+  m_endTxEvents.clear ();
 }
 
 void
@@ -132,9 +141,13 @@ LoraTransducerHd::Receive (Ptr<Packet> packet,
                             pdp,
                             Simulator::Now ());
 
-  m_arrivalList.push_back (arrival);
-  Time txDelay = Seconds (packet->GetSize () * 8.0 / txMode.GetDataRateBps ());
-  Simulator::Schedule (txDelay, &LoraTransducerHd::RemoveArrival, this, arrival);
+  // The removal event only carries the arrival id, which stays valid
+  // after a Clear wipes the list.
+  uint64_t id = m_nextArrivalId++;
+  m_arrivalIndex[id] = m_arrivalList.insert (m_arrivalList.end (), arrival);
+  AddArrivalPower (arrival);
+  Time txDelay = txMode.GetTimeOnAir (packet->GetSize ());
+  Simulator::Schedule (txDelay, &LoraTransducerHd::RemoveArrival, this, id);
   NS_LOG_DEBUG (Simulator::Now ().GetSeconds () << " Transducer in receive");
   if (m_state == RX)
     {
@@ -156,7 +169,9 @@ LoraTransducerHd::Transmit (Ptr<LoraPhy> src,
 {
   if (m_state == TX)
     {
-      Simulator::Remove (m_endTxEvent);
+      // The pending end of TX event still reports the end of the
+      // previous packet, and leaves TX state only once m_endTxTime
+      // is reached.
       src->NotifyTxDrop(packet);           // traced source netanim
     }
   else
@@ -166,7 +181,7 @@ LoraTransducerHd::Transmit (Ptr<LoraPhy> src,
     }
 
 
-  Time delay = Seconds (packet->GetSize () * 8.0 / txMode.GetDataRateBps ());
+  Time delay = txMode.GetTimeOnAir (packet->GetSize ());
   NS_LOG_DEBUG ("Transducer transmitting:  TX delay = "
                 << delay << " seconds for packet size "
                 << packet->GetSize () << " bytes and rate = "
@@ -182,26 +197,34 @@ LoraTransducerHd::Transmit (Ptr<LoraPhy> src,
   m_channel->TxPacket (Ptr<LoraTransducer> (this), packet, txPowerDb, txMode);
 
 
+  // As with the former separate NotifyTxEnd events, a transmission
+  // overlapping another one reports its end no earlier than the end of
+  // the previous one, so that the end of TX events fire in order.
   delay = std::max (delay, m_endTxTime - Simulator::Now ());
 
-  m_endTxEvent = Simulator::Schedule (delay, &LoraTransducerHd::EndTx, this);
+  m_endTxEvents.push_back (Simulator::Schedule (delay, &LoraTransducerHd::EndTx, this, src, packet));
   m_endTxTime = Simulator::Now () + delay;
-  Simulator::Schedule(delay, &LoraPhy::NotifyTxEnd, src, packet);    // traced source netanim
 }
 
 void
-LoraTransducerHd::EndTx (void)
+LoraTransducerHd::EndTx (Ptr<LoraPhy> src, Ptr<Packet> packet)
 {
-  NS_ASSERT (m_state == TX);
-  m_state = RX;
-  m_endTxTime = Seconds (0);
+  m_endTxEvents.pop_front ();
+  src->NotifyTxEnd (packet);    // traced source netanim
+
+  // An overlapping transmission may have pushed the end of TX further
+  if (m_state == TX && Simulator::Now () >= m_endTxTime)
+    {
+      m_state = RX;
+      m_endTxTime = Seconds (0);
+    }
 }
 void
 LoraTransducerHd::SetChannel (Ptr<LoraChannel> chan)
 {
   NS_LOG_DEBUG ("Transducer setting channel");
   m_channel = chan;
-
+  ResetNoiseCache ();
 }
 Ptr<LoraChannel>
 LoraTransducerHd::GetChannel (void) const
@@ -221,23 +244,26 @@ LoraTransducerHd::GetPhyList (void) const
 }
 
 void
-LoraTransducerHd::RemoveArrival (LoraPacketArrival arrival)
+LoraTransducerHd::RemoveArrival (uint64_t id)
 {
 
   // Remove entry from arrival list
-  ArrivalList::iterator it = m_arrivalList.begin ();
-  for (; it != m_arrivalList.end (); it++)
+  ArrivalIndex::iterator it = m_arrivalIndex.find (id);
+  if (it == m_arrivalIndex.end ())
     {
-      if (it->GetPacket () == arrival.GetPacket ())
-        {
-          m_arrivalList.erase (it);
-          break;
-        }
+      return;
     }
+  LoraPacketArrival arrival = *it->second;
+  m_arrivalList.erase (it->second);
+  m_arrivalIndex.erase (it);
+  RemoveArrivalPower (arrival);
+
+  // Single end of frame event: the phys end their reception of the
+  // packet or update their CCA state from here.
   LoraPhyList::const_iterator ait = m_phyList.begin ();
   for (; ait != m_phyList.end (); ait++)
     {
-      (*ait)->NotifyIntChange ();
+      (*ait)->NotifyArrivalEnd (arrival.GetPacket (), arrival.GetRxPowerDb (), arrival.GetTxMode ());
     }
 
 }
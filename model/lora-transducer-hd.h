@@ -22,6 +22,10 @@
 
 #include "lora-transducer.h"
 #include "ns3/simulator.h"
+
+#include <deque>
+#include <map>
+
 namespace ns3 {
 
 /**
@@ -63,18 +67,28 @@ private:
   ArrivalList m_arrivalList;  //!< List of arriving packets which overlap in time.
   LoraPhyList m_phyList;       //!< List of physical layers attached above this tranducer.
   Ptr<LoraChannel> m_channel;  //!< The attached channel.
-  EventId m_endTxEvent;       //!< Event scheduled for end of transmission.
+  std::deque<EventId> m_endTxEvents;  //!< Pending end of transmission events, in schedule order.
   Time m_endTxTime;           //!< Time at which transmission will be completed.
   bool m_cleared;             //!< Flab when we've been cleared.
 
+  /** Arrival list entry of each arrival id. */
+  typedef std::map<uint64_t, ArrivalList::iterator> ArrivalIndex;
+  ArrivalIndex m_arrivalIndex;  //!< Arrival list entry of each pending arrival.
+  uint64_t m_nextArrivalId;     //!< Id given to the next arrival.
+
   /**
    * Remove an entry from the arrival list.
    *
-   * \param arrival The packet arrival to remove.
+   * \param id The id of the packet arrival to remove.
+   */
+  void RemoveArrival (uint64_t id);
+  /**
+   * Handle end of transmission event.
+   *
+   * \param src The phy which sent the packet.
+   * \param packet The packet whose transmission ends.
    */
-  void RemoveArrival (LoraPacketArrival arrival);
-  /** Handle end of transmission event. */
-  void EndTx (void);
+  void EndTx (Ptr<LoraPhy> src, Ptr<Packet> packet);
 protected:
   virtual void DoDispose ();
 
@@ -18,11 +18,21 @@
  */
 
 #include "lora-transducer.h"
+#include "lora-channel.h"
+
+#include <cmath>
 
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (LoraTransducer);
 
+LoraTransducer::LoraTransducer ()
+  : Object (),
+    m_rxPowerDbValid (false),
+    m_rxPowerDb (0)
+{
+}
+
 TypeId LoraTransducer::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::LoraTransducer")
@@ -32,4 +42,198 @@ TypeId LoraTransducer::GetTypeId (void)
   return tid;
 }
 
+double
+LoraTransducer::GetRxPowerKp (void) const
+{
+  double kp = 0;
+  for (uint32_t i = 0; i < m_bandKp.size (); i++)
+    {
+      kp += m_bandKp[i];
+    }
+  return kp;
+}
+
+double
+LoraTransducer::GetRxPowerDb (void) const
+{
+  if (!m_rxPowerDbValid)
+    {
+      m_rxPowerDb = 10 * std::log10 (GetRxPowerKp ());
+      m_rxPowerDbValid = true;
+    }
+  return m_rxPowerDb;
+}
+
+double
+LoraTransducer::GetBandRxPowerKp (uint32_t cfHz, uint32_t bwHz) const
+{
+  for (uint32_t q = 0; q < m_queryCfHz.size (); q++)
+    {
+      if (m_queryCfHz[q] == cfHz && m_queryBwHz[q] == bwHz)
+        {
+          return m_queryKp[q];
+        }
+    }
+
+  // Same overlap test as LoraPhyCalcSinrDual.  The power of each band
+  // is loaded unconditionally so that the test is a select, which the
+  // compiler vectorizes; a conditional add into the sum would not be.
+  // The sum is then taken in band order, as before.
+  double cf = cfHz;
+  double halfBw = (double)(bwHz / 2) - 0.5;
+  uint32_t n = m_bandKp.size ();
+  m_bandOverlapKp.resize (n);
+  const double *bandCf = n == 0 ? 0 : &m_bandCf[0];
+  const double *bandHalfBw = n == 0 ? 0 : &m_bandHalfBw[0];
+  const double *bandKp = n == 0 ? 0 : &m_bandKp[0];
+  double *overlapKp = n == 0 ? 0 : &m_bandOverlapKp[0];
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double bkp = bandKp[i];
+      overlapKp[i] = std::abs (bandCf[i] - cf) < bandHalfBw[i] + halfBw ? bkp : 0.0;
+    }
+  double kp = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      kp += overlapKp[i];
+    }
+  m_queryCfHz.push_back (cfHz);
+  m_queryBwHz.push_back (bwHz);
+  m_queryKp.push_back (kp);
+  return kp;
+}
+
+double
+LoraTransducer::GetNoiseDb (LoraTxMode mode) const
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid >= m_noiseDbValid.size ())
+    {
+      m_noiseDb.resize (uid + 1, 0);
+      m_noiseDbValid.resize (uid + 1, false);
+    }
+  if (!m_noiseDbValid[uid])
+    {
+      m_noiseDb[uid] = GetChannel ()->GetNoiseDbHz ((double) mode.GetCenterFreqHz () / 1000.0)
+        + 10 * std::log10 (mode.GetBandwidthHz ());
+      m_noiseDbValid[uid] = true;
+    }
+  return m_noiseDb[uid];
+}
+
+void
+LoraTransducer::ResetNoiseCache (void)
+{
+  m_noiseDb.clear ();
+  m_noiseDbValid.clear ();
+}
+
+void
+LoraTransducer::ArrivalsChanged (void)
+{
+  m_rxPowerDbValid = false;
+  m_queryCfHz.clear ();
+  m_queryBwHz.clear ();
+  m_queryKp.clear ();
+}
+
+uint32_t
+LoraTransducer::FindBand (uint32_t cfHz, uint32_t bwHz) const
+{
+  uint32_t i = 0;
+  for (; i < m_bandCfHz.size (); i++)
+    {
+      if (m_bandCfHz[i] == cfHz && m_bandBwHz[i] == bwHz)
+        {
+          break;
+        }
+    }
+  return i;
+}
+
+void
+LoraTransducer::AddArrivalPower (const LoraPacketArrival &arrival)
+{
+  ArrivalsChanged ();
+  const LoraTxMode &mode = arrival.GetTxMode ();
+  uint32_t cfHz = mode.GetCenterFreqHz ();
+  uint32_t bwHz = mode.GetBandwidthHz ();
+  uint32_t i = FindBand (cfHz, bwHz);
+  if (i == m_bandCfHz.size ())
+    {
+      m_bandCfHz.push_back (cfHz);
+      m_bandBwHz.push_back (bwHz);
+      m_bandCf.push_back (cfHz);
+      m_bandHalfBw.push_back (bwHz / 2);
+      m_bandKp.push_back (0);
+      m_bandCount.push_back (0);
+    }
+  m_bandKp[i] += std::pow (10, arrival.GetRxPowerDb () / 10.0);
+  m_bandCount[i]++;
+}
+
+void
+LoraTransducer::RemoveArrivalPower (const LoraPacketArrival &arrival)
+{
+  ArrivalsChanged ();
+  const LoraTxMode &mode = arrival.GetTxMode ();
+  uint32_t cfHz = mode.GetCenterFreqHz ();
+  uint32_t bwHz = mode.GetBandwidthHz ();
+  uint32_t i = FindBand (cfHz, bwHz);
+  if (i == m_bandCfHz.size ())
+    {
+      return;
+    }
+  if (--m_bandCount[i] == 0)
+    {
+      // Move the last band in place of the emptied one
+      uint32_t last = m_bandCfHz.size () - 1;
+      m_bandCfHz[i] = m_bandCfHz[last];
+      m_bandBwHz[i] = m_bandBwHz[last];
+      m_bandCf[i] = m_bandCf[last];
+      m_bandHalfBw[i] = m_bandHalfBw[last];
+      m_bandKp[i] = m_bandKp[last];
+      m_bandCount[i] = m_bandCount[last];
+      m_bandCfHz.pop_back ();
+      m_bandBwHz.pop_back ();
+      m_bandCf.pop_back ();
+      m_bandHalfBw.pop_back ();
+      m_bandKp.pop_back ();
+      m_bandCount.pop_back ();
+      return;
+    }
+
+  double kp = std::pow (10, arrival.GetRxPowerDb () / 10.0);
+  m_bandKp[i] -= kp;
+  // Subtracting a signal much stronger than the ones left loses their
+  // precision: sum the remaining arrivals of the band again.
+  if (m_bandKp[i] * 1e3 < kp)
+    {
+      double sum = 0;
+      const ArrivalList &arrivals = GetArrivalList ();
+      ArrivalList::const_iterator ait = arrivals.begin ();
+      for (; ait != arrivals.end (); ait++)
+        {
+          if (ait->GetTxMode ().GetCenterFreqHz () == cfHz
+              && ait->GetTxMode ().GetBandwidthHz () == bwHz)
+            {
+              sum += std::pow (10, ait->GetRxPowerDb () / 10.0);
+            }
+        }
+      m_bandKp[i] = sum;
+    }
+}
+
+void
+LoraTransducer::ClearArrivalPower (void)
+{
+  ArrivalsChanged ();
+  m_bandCfHz.clear ();
+  m_bandBwHz.clear ();
+  m_bandCf.clear ();
+  m_bandHalfBw.clear ();
+  m_bandKp.clear ();
+  m_bandCount.clear ();
+}
+
 } // namespace ns3
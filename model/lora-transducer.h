@@ -26,6 +26,7 @@
 #include "ns3/lora-prop-model.h"
 
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -111,7 +112,7 @@ public:
    *
    * \return PDP of arriving signal.
    */
-  inline LoraPdp GetPdp (void) const
+  inline const LoraPdp &GetPdp (void) const
   {
     return m_pdp;
   }
@@ -132,6 +133,9 @@ private:
 class LoraTransducer : public Object
 {
 public:
+  /** Constructor */
+  LoraTransducer ();
+
   /**
    * Register this type.
    * \return The object TypeId.
@@ -178,7 +182,8 @@ public:
   /**
    * Notify this object that a new packet has arrived at this nodes location
    *
-   * \param packet Packet arriving.
+   * \param packet Packet arriving, shared with the other receivers
+   *   of the transmission and thus not to be modified.
    * \param rxPowerDb Signal power in dB of arriving packet.
    * \param txMode Mode arriving packet is using.
    * \param pdp PDP of arriving signal.
@@ -224,6 +229,104 @@ public:
    */
   virtual void Clear (void) = 0;
 
+  /**
+   * Get the total power of the arrivals in the arrival list.
+   *
+   * The power is maintained incrementally as arrivals come and go,
+   * so this does not scan the arrival list.
+   *
+   * \return Total received power, in linear units.
+   */
+  double GetRxPowerKp (void) const;
+  /**
+   * Get the total power of the arrivals in the arrival list, in dB.
+   *
+   * Evaluated at most once per arrival event, so the PHYs sharing
+   * this transducer all reuse the same figure for their CCA checks.
+   *
+   * \return Total received power, in dB.
+   */
+  double GetRxPowerDb (void) const;
+  /**
+   * Get the total power of the arrivals whose band overlaps a band.
+   *
+   * Results are kept until the next arrival event, so sibling PHYs
+   * receiving on the same band share one evaluation.
+   *
+   * \param cfHz Center frequency of the band, in Hz.
+   * \param bwHz Bandwidth of the band, in Hz.
+   * \return Total received power in the band, in linear units.
+   */
+  double GetBandRxPowerKp (uint32_t cfHz, uint32_t bwHz) const;
+  /**
+   * Get the ambient noise power over the band of a mode.
+   *
+   * The channel noise model is evaluated once per mode and the result
+   * is shared by the PHYs attached to this transducer.
+   *
+   * \param mode The mode.
+   * \return Noise power over the mode bandwidth, in dB.
+   */
+  double GetNoiseDb (LoraTxMode mode) const;
+  /**
+   * Forget the noise figures, after a change of channel or of the
+   * channel noise model.
+   */
+  void ResetNoiseCache (void);
+
+protected:
+  /**
+   * Account for an arrival just added to the arrival list.
+   *
+   * \param arrival The arrival.
+   */
+  void AddArrivalPower (const LoraPacketArrival &arrival);
+  /**
+   * Account for an arrival just removed from the arrival list.
+   *
+   * \param arrival The arrival.
+   */
+  void RemoveArrivalPower (const LoraPacketArrival &arrival);
+  /** Forget all arrivals. */
+  void ClearArrivalPower (void);
+
+private:
+  /**
+   * Find the band of a mode in the running sums.
+   *
+   * \param cfHz Center frequency, in Hz.
+   * \param bwHz Bandwidth, in Hz.
+   * \return Index of the band, or the number of bands if not found.
+   */
+  uint32_t FindBand (uint32_t cfHz, uint32_t bwHz) const;
+  /** Drop the figures computed for the previous arrival event. */
+  void ArrivalsChanged (void);
+
+  /*
+   * Running sums of the arrivals, one entry per (center frequency,
+   * bandwidth) band, stored as parallel arrays so that band queries
+   * are a branch-free loop over contiguous data.
+   */
+  std::vector<uint32_t> m_bandCfHz;      //!< Center frequency of each band, in Hz.
+  std::vector<uint32_t> m_bandBwHz;      //!< Bandwidth of each band, in Hz.
+  std::vector<double> m_bandCf;          //!< Center frequency of each band, in Hz.
+  std::vector<double> m_bandHalfBw;      //!< Half bandwidth of each band, rounded down, in Hz.
+  std::vector<double> m_bandKp;          //!< Total power of each band, in linear units.
+  std::vector<uint32_t> m_bandCount;     //!< Number of arrivals of each band.
+
+  /*
+   * Figures computed on demand and kept until the next arrival event.
+   */
+  mutable bool m_rxPowerDbValid;             //!< True if m_rxPowerDb is up to date.
+  mutable double m_rxPowerDb;                //!< Total power, in dB.
+  mutable std::vector<uint32_t> m_queryCfHz; //!< Center frequency of each queried band, in Hz.
+  mutable std::vector<uint32_t> m_queryBwHz; //!< Bandwidth of each queried band, in Hz.
+  mutable std::vector<double> m_queryKp;     //!< Power overlapping each queried band.
+  mutable std::vector<double> m_bandOverlapKp; //!< Scratch: power of each band if it overlaps the queried one.
+
+  mutable std::vector<double> m_noiseDb;     //!< Noise over each mode band, indexed by uid.
+  mutable std::vector<bool> m_noiseDbValid;  //!< True for the uids in m_noiseDb.
+
 };  // class LoraTransducer
 
 } // namespace ns3
@@ -18,8 +18,9 @@
  */
 #include "lora-tx-mode.h"
 #include "ns3/log.h"
-#include <map>
 #include <utility>
+#include <algorithm>
+#include <cmath>
 
 namespace ns3 {
 
@@ -70,6 +71,47 @@ LoraTxMode::GetConstellationSize (void) const
   return LoraTxModeFactory::GetFactory ().GetModeItem (m_uid).m_constSize;
 }
 
+uint32_t
+LoraTxMode::GetSpreadingFactor (void) const
+{
+  return LoraTxModeFactory::GetFactory ().GetModeItem (m_uid).m_sf;
+}
+
+uint32_t
+LoraTxMode::GetCodingRate (void) const
+{
+  return LoraTxModeFactory::GetFactory ().GetModeItem (m_uid).m_codingRate;
+}
+
+uint32_t
+LoraTxMode::GetPreambleLength (void) const
+{
+  return LoraTxModeFactory::GetFactory ().GetModeItem (m_uid).m_preambleLength;
+}
+
+bool
+LoraTxMode::HasExplicitHeader (void) const
+{
+  return LoraTxModeFactory::GetFactory ().GetModeItem (m_uid).m_explicitHeader;
+}
+
+bool
+LoraTxMode::HasLowDataRateOptimization (void) const
+{
+  return LoraTxModeFactory::GetFactory ().GetModeItem (m_uid).m_lowDataRateOpt;
+}
+
+Time
+LoraTxMode::GetTimeOnAir (uint32_t bytes) const
+{
+  const LoraTxModeFactory::LoraTxModeItem &item = LoraTxModeFactory::GetFactory ().GetModeItem (m_uid);
+  if (bytes < item.m_timeOnAir.size ())
+    {
+      return item.m_timeOnAir[bytes];
+    }
+  return LoraTxModeFactory::CalculateTimeOnAir (item, bytes);
+}
+
 std::string
 LoraTxMode::GetName (void) const
 {
@@ -103,6 +145,8 @@ operator>> (std::istream & is, LoraTxMode &mode)
 
 
 
+const uint32_t LoraTxModeFactory::TOA_TABLE_SIZE;
+
 LoraTxModeFactory::LoraTxModeFactory ()
   : m_nextUid (0)
 {
@@ -111,20 +155,12 @@ LoraTxModeFactory::LoraTxModeFactory ()
 LoraTxModeFactory::~LoraTxModeFactory ()
 {
   m_modes.clear ();
+  m_names.clear ();
 }
 bool
 LoraTxModeFactory::NameUsed (std::string name)
 {
-  std::map<uint32_t, LoraTxModeItem>::iterator it = m_modes.begin ();
-
-  for (; it != m_modes.end (); it++)
-    {
-      if ((*it).second.m_name == name)
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_names.find (name) != m_names.end ();
 }
 
 LoraTxMode
@@ -148,8 +184,10 @@ LoraTxModeFactory::CreateMode (LoraTxMode::ModulationType type,
     }
   else
     {
-      item = &factory.m_modes[factory.m_nextUid];
+      factory.m_modes.push_back (LoraTxModeItem ());
+      item = &factory.m_modes.back ();
       item->m_uid = factory.m_nextUid++;
+      factory.m_names[name] = item->m_uid;
     }
 
   item->m_type = type;
@@ -158,10 +196,87 @@ LoraTxModeFactory::CreateMode (LoraTxMode::ModulationType type,
   item->m_cfHz = cfHz;
   item->m_bwHz = bwHz;
   item->m_constSize = constSize;
+  item->m_sf = 0;
+  item->m_codingRate = 0;
+  item->m_preambleLength = 0;
+  item->m_explicitHeader = false;
+  item->m_lowDataRateOpt = false;
   item->m_name = name;
+  FillTimeOnAir (*item);
   return factory.MakeModeFromItem (*item);
 }
 
+LoraTxMode
+LoraTxModeFactory::CreateLoraMode (uint32_t sf,
+                                  uint32_t bwHz,
+                                  uint32_t codingRate,
+                                  uint32_t cfHz,
+                                  uint32_t preambleLength,
+                                  bool explicitHeader,
+                                  bool lowDataRateOpt,
+                                  std::string name)
+{
+  if (sf < 7 || sf > 12)
+    {
+      NS_FATAL_ERROR ("Invalid LoRa spreading factor " << sf);
+    }
+  if (codingRate < 1 || codingRate > 4)
+    {
+      NS_FATAL_ERROR ("Invalid LoRa coding rate 4/" << codingRate + 4);
+    }
+  if (bwHz == 0)
+    {
+      NS_FATAL_ERROR ("Invalid LoRa bandwidth " << bwHz);
+    }
+
+  uint32_t chips = 1 << sf;
+  double dataRateBps = sf * (4.0 / (4 + codingRate)) * bwHz / chips;
+  LoraTxMode mode = CreateMode (LoraTxMode::LORA,
+                                static_cast<uint32_t> (dataRateBps + 0.5),
+                                (bwHz + chips / 2) / chips,
+                                cfHz,
+                                bwHz,
+                                chips,
+                                name);
+
+  LoraTxModeItem &item = GetFactory ().GetModeItem (mode.GetUid ());
+  item.m_sf = sf;
+  item.m_codingRate = codingRate;
+  item.m_preambleLength = preambleLength;
+  item.m_explicitHeader = explicitHeader;
+  item.m_lowDataRateOpt = lowDataRateOpt;
+  FillTimeOnAir (item);
+  return mode;
+}
+
+Time
+LoraTxModeFactory::CalculateTimeOnAir (const LoraTxModeItem &item, uint32_t bytes)
+{
+  if (item.m_sf == 0)
+    {
+      return Seconds (bytes * 8.0 / item.m_dataRateBps);
+    }
+
+  // Semtech SX1272/76 datasheet formula, with the payload CRC on
+  double tSym = (double)(1 << item.m_sf) / item.m_bwHz;
+  int32_t de = item.m_lowDataRateOpt ? 1 : 0;
+  int32_t ih = item.m_explicitHeader ? 0 : 1;
+  int32_t num = 8 * (int32_t) bytes - 4 * (int32_t) item.m_sf + 28 + 16 - 20 * ih;
+  int32_t den = 4 * ((int32_t) item.m_sf - 2 * de);
+  double nPayload = 8 + std::max (std::ceil ((double) num / den) * (item.m_codingRate + 4), 0.0);
+  return Seconds ((item.m_preambleLength + 4.25 + nPayload) * tSym);
+}
+
+void
+LoraTxModeFactory::FillTimeOnAir (LoraTxModeItem &item)
+{
+  item.m_timeOnAir.resize (TOA_TABLE_SIZE);
+  for (uint32_t bytes = 0; bytes < TOA_TABLE_SIZE; bytes++)
+    {
+      item.m_timeOnAir[bytes] = CalculateTimeOnAir (item, bytes);
+    }
+}
+
 LoraTxModeFactory::LoraTxModeItem &
 LoraTxModeFactory::GetModeItem (uint32_t uid)
 {
@@ -177,16 +292,13 @@ LoraTxModeFactory::GetModeItem (uint32_t uid)
 LoraTxModeFactory::LoraTxModeItem &
 LoraTxModeFactory::GetModeItem (std::string name)
 {
-  std::map<uint32_t, LoraTxModeItem>::iterator it = m_modes.begin ();
-  for (; it != m_modes.end (); it++)
+  std::map<std::string, uint32_t>::iterator it = m_names.find (name);
+  if (it == m_names.end ())
     {
-      if ((*it).second.m_name == name)
-        {
-          return (*it).second;
-        }
+      NS_FATAL_ERROR ("Unknown mode, \"" << name << "\", requested from mode factory");
     }
-  NS_FATAL_ERROR ("Unknown mode, \"" << name << "\", requested from mode factory");
-  return (*it).second;  // dummy to get rid of warning
+
+  return m_modes[it->second];
 }
 
 LoraTxMode
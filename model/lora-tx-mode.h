@@ -21,6 +21,9 @@
 #define LORA_TX_MODE_H
 
 #include "ns3/object.h"
+#include "ns3/nstime.h"
+#include <vector>
+#include <deque>
 #include <map>
 
 namespace ns3 {
@@ -64,6 +67,9 @@ public:
   /**
    * Get the physical signaling rate.
    *
+   * Rounded to the nearest integer: exact LoRa timings come from
+   * GetTimeOnAir.
+   *
    * \return PHY rate in symbols per second.
    */
   uint32_t GetPhyRateSps (void) const;
@@ -85,6 +91,51 @@ public:
    * \return Number of constellation points.
    */
   uint32_t GetConstellationSize (void) const;
+  /**
+   * Get the LoRa spreading factor.
+   *
+   * \return Spreading factor (7 to 12), or 0 if the mode was not
+   *         created by LoraTxModeFactory::CreateLoraMode.
+   */
+  uint32_t GetSpreadingFactor (void) const;
+  /**
+   * Get the LoRa coding rate.
+   *
+   * \return Coding rate index, 1 to 4 for rates 4/5 to 4/8, or 0 for
+   *         modes which are not LoRa-native.
+   */
+  uint32_t GetCodingRate (void) const;
+  /**
+   * Get the number of programmed preamble symbols.
+   *
+   * \return Preamble length, in symbols.
+   */
+  uint32_t GetPreambleLength (void) const;
+  /**
+   * Check if frames carry an explicit LoRa PHY header.
+   *
+   * \return True for explicit header mode.
+   */
+  bool HasExplicitHeader (void) const;
+  /**
+   * Check if low data rate optimization is enabled.
+   *
+   * \return True if low data rate optimization is on.
+   */
+  bool HasLowDataRateOptimization (void) const;
+  /**
+   * Get the time needed to transmit a frame.
+   *
+   * For LoRa-native modes, this is the LoRa time on air including the
+   * preamble, the header and the payload CRC. For other modes, this is
+   * the payload size divided by the data rate. Sizes up to
+   * LoraTxModeFactory::TOA_TABLE_SIZE - 1 bytes are read from a table
+   * computed when the mode is created.
+   *
+   * \param bytes Payload size, in bytes.
+   * \return Time on air of the frame.
+   */
+  Time GetTimeOnAir (uint32_t bytes) const;
   /**
    * Get the mode name.
    *
@@ -156,6 +207,37 @@ public:
                                uint32_t constSize,
                                std::string name);
 
+  /**
+   * Create a LoRa transmission mode from its LoRa parameters.
+   *
+   * The data rate, symbol rate and constellation size are derived
+   * from the spreading factor, the bandwidth and the coding rate.
+   * The payload CRC is always on.
+   *
+   * \param sf Spreading factor, 7 to 12.
+   * \param bwHz Bandwidth in Hz.
+   * \param codingRate Coding rate index, 1 to 4 for rates 4/5 to 4/8.
+   * \param cfHz Center frequency in Hz.
+   * \param preambleLength Number of programmed preamble symbols.
+   * \param explicitHeader True for explicit header mode.
+   * \param lowDataRateOpt True to enable low data rate optimization,
+   *        which LoRa mandates for symbols longer than 16 ms.
+   * \param name Unique string name for this transmission mode.
+   *
+   * \return the transmit mode object
+   */
+  static LoraTxMode CreateLoraMode (uint32_t sf,
+                                   uint32_t bwHz,
+                                   uint32_t codingRate,
+                                   uint32_t cfHz,
+                                   uint32_t preambleLength,
+                                   bool explicitHeader,
+                                   bool lowDataRateOpt,
+                                   std::string name);
+
+  /** Number of payload sizes with a precomputed time on air. */
+  static const uint32_t TOA_TABLE_SIZE = 256;
+
   /**
    * Get a mode by name.
    *
@@ -187,15 +269,27 @@ private:
     uint32_t m_dataRateBps;            //!< Data rate in BPS.
     uint32_t m_phyRateSps;             //!< Symbol rate in symbols per second.
     uint32_t m_constSize;              //!< Modulation constellation size (2 for BPSK, 4 for QPSK).
+    uint32_t m_sf;                     //!< LoRa spreading factor, 0 if not LoRa-native.
+    uint32_t m_codingRate;             //!< LoRa coding rate index.
+    uint32_t m_preambleLength;         //!< Preamble length in symbols.
+    bool m_explicitHeader;             //!< Explicit LoRa header.
+    bool m_lowDataRateOpt;             //!< LoRa low data rate optimization.
+    std::vector<Time> m_timeOnAir;     //!< Time on air, indexed by payload size.
     uint32_t m_uid;                    //!< Unique id.
     std::string m_name;                //!< Unique string name for this transmission mode.
   };
 
   /**
-   * Container for modes
+   * Container for modes, indexed by uid.
    *
+   * Uids are allocated contiguously, so mode lookups from the
+   * LoraTxMode getters are indexed loads.  A deque never moves its
+   * elements on push_back, so references returned by GetModeItem stay
+   * valid when modes are created later.
    */
-  std::map<uint32_t, LoraTxModeItem> m_modes;
+  std::deque<LoraTxModeItem> m_modes;
+  /** Uid of each mode name. */
+  std::map<std::string, uint32_t> m_names;
 
   /**
    * Check if the mode \pname{name} already exists.
@@ -227,6 +321,21 @@ private:
    */
   LoraTxModeItem &GetModeItem (std::string name);
 
+  /**
+   * Compute the time on air of a frame.
+   *
+   * \param item The mode.
+   * \param bytes Payload size, in bytes.
+   * \return Time on air of the frame.
+   */
+  static Time CalculateTimeOnAir (const LoraTxModeItem &item, uint32_t bytes);
+  /**
+   * Fill the time on air table of a mode.
+   *
+   * \param item The mode.
+   */
+  static void FillTimeOnAir (LoraTxModeItem &item);
+
   /**
    * Create a public LoraTxMode from an internal LoraTxModeItem.
    *
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lora-worker-pool.h"
+#include "ns3/assert.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+LoraWorkerPool::LoraWorkerPool (uint32_t nThreads)
+  : m_job (0),
+    m_n (0),
+    m_chunk (1),
+    m_next (0),
+    m_busy (0),
+    m_generation (0),
+    m_stop (false)
+{
+  NS_ASSERT (nThreads > 0);
+  // The thread calling Run takes part in the job.
+  for (uint32_t i = 1; i < nThreads; i++)
+    {
+      m_threads.push_back (std::thread (&LoraWorkerPool::WorkerLoop, this));
+    }
+}
+
+LoraWorkerPool::~LoraWorkerPool ()
+{
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_wake.notify_all ();
+  for (uint32_t i = 0; i < m_threads.size (); i++)
+    {
+      m_threads[i].join ();
+    }
+}
+
+uint32_t
+LoraWorkerPool::GetNThreads (void) const
+{
+  return m_threads.size () + 1;
+}
+
+void
+LoraWorkerPool::Run (uint32_t n, Job *job)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_job = job;
+  m_n = n;
+  m_next = 0;
+  // A few chunks per thread, to balance uneven slices.
+  m_chunk = std::max<uint32_t> (1, n / (4 * GetNThreads ()));
+  m_generation++;
+  m_busy++;
+  m_wake.notify_all ();
+
+  RunChunks (lock);
+  m_busy--;
+  while (m_busy > 0 || m_next < m_n)
+    {
+      m_done.wait (lock);
+    }
+  m_job = 0;
+}
+
+void
+LoraWorkerPool::WorkerLoop (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  uint32_t seen = 0;
+  while (true)
+    {
+      while (!m_stop && seen == m_generation)
+        {
+          m_wake.wait (lock);
+        }
+      if (m_stop)
+        {
+          return;
+        }
+      seen = m_generation;
+      m_busy++;
+      RunChunks (lock);
+      m_busy--;
+      if (m_busy == 0)
+        {
+          m_done.notify_all ();
+        }
+    }
+}
+
+void
+LoraWorkerPool::RunChunks (std::unique_lock<std::mutex> &lock)
+{
+  while (m_next < m_n)
+    {
+      uint32_t begin = m_next;
+      uint32_t end = std::min (begin + m_chunk, m_n);
+      m_next = end;
+      Job *job = m_job;
+      lock.unlock ();
+      job->Execute (begin, end);
+      lock.lock ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LORA_WORKER_POOL_H
+#define LORA_WORKER_POOL_H
+
+#include "ns3/simple-ref-count.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace ns3 {
+
+/**
+ *
+ * Fixed pool of threads running index ranges of a job in parallel.
+ *
+ * The threads never touch the simulator: jobs must only read shared
+ * state and write to their own slice of the output, in particular
+ * they must not copy Ptr objects shared between slices, whose
+ * reference counts are not atomic.
+ */
+class LoraWorkerPool : public SimpleRefCount<LoraWorkerPool>
+{
+public:
+  /**
+   * A job over a range of indices.
+   */
+  class Job
+  {
+  public:
+    virtual ~Job () {}
+    /**
+     * Process indices [begin, end).
+     *
+     * \param begin First index.
+     * \param end Index past the last one.
+     */
+    virtual void Execute (uint32_t begin, uint32_t end) = 0;
+  };
+
+  /**
+   * Start the worker threads.
+   *
+   * \param nThreads Number of threads running a job, including the caller.
+   */
+  LoraWorkerPool (uint32_t nThreads);
+  /** Stop and join the worker threads. */
+  ~LoraWorkerPool ();
+
+  /**
+   * Run a job over [0, n), split in chunks shared among the threads,
+   * and return once all of them have been processed.
+   *
+   * \param n Number of indices.
+   * \param job The job.
+   */
+  void Run (uint32_t n, Job *job);
+
+  /** \return Number of threads running a job, including the caller. */
+  uint32_t GetNThreads (void) const;
+
+private:
+  /** Main loop of a worker thread. */
+  void WorkerLoop (void);
+  /**
+   * Process chunks of the current job until none is left.
+   *
+   * \param lock Lock on m_mutex, held on entry and exit.
+   */
+  void RunChunks (std::unique_lock<std::mutex> &lock);
+
+  std::vector<std::thread> m_threads;  //!< Worker threads.
+  std::mutex m_mutex;                  //!< Protects the job state.
+  std::condition_variable m_wake;      //!< Signals a new job or stop.
+  std::condition_variable m_done;      //!< Signals the end of a job.
+  Job *m_job;                          //!< Current job.
+  uint32_t m_n;                        //!< Number of indices of the job.
+  uint32_t m_chunk;                    //!< Indices per chunk.
+  uint32_t m_next;                     //!< First index not handed out yet.
+  uint32_t m_busy;                     //!< Threads processing chunks.
+  uint32_t m_generation;               //!< Number of jobs started.
+  bool m_stop;                         //!< The workers must exit.
+
+};  // class LoraWorkerPool
+
+} // namespace ns3
+
+#endif /* LORA_WORKER_POOL_H */
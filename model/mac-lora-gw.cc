@@ -35,6 +35,7 @@ NS_OBJECT_ENSURE_REGISTERED (MacLoraAca);
 
 MacLoraAca::MacLoraAca ()
   : LoraMac (),
+    m_frameCounter (0),
     m_cleared (false)
 {
 }
@@ -107,6 +108,17 @@ MacLoraAca::Enqueue (Ptr<Packet> packet, const Address &dest, uint16_t protocolN
       header.SetPreamble(12);
 
       packet->AddHeader (header);
+      // A packet received earlier, e.g. relayed, still carries its tag.
+      LoraFrameCounterTag tag (m_frameCounter++);
+      LoraFrameCounterTag previous;
+      if (packet->PeekPacketTag (previous))
+        {
+          packet->ReplacePacketTag (tag);
+        }
+      else
+        {
+          packet->AddPacketTag (tag);
+        }
       m_phy->SendPacket (packet, protocolNumber);
       return true;
     }
@@ -120,6 +132,11 @@ MacLoraAca::SetForwardUpCb (Callback<void, Ptr<Packet>, const LoraAddress& > cb)
   m_forUpCb = cb;
 }
 void
+MacLoraAca::SetUplinkCallback (Callback<void, Ptr<Packet>, const LoraAddress&, double, const LoraAddress& > cb)
+{
+  m_uplinkCb = cb;
+}
+void
 MacLoraAca::AttachPhy (Ptr<LoraPhy> phy)
 {
   m_phy = phy;
@@ -134,6 +151,11 @@ MacLoraAca::RxPacketGood (Ptr<Packet> pkt, double sinr, LoraTxMode txMode)
   pkt->RemoveHeader (header);
   NS_LOG_DEBUG ("Receiving packet from " << header.GetSrc () << " For " << header.GetDest ());
 
+  if (!m_uplinkCb.IsNull ())
+    {
+      m_uplinkCb (pkt->Copy (), header.GetSrc (), sinr, m_address);
+    }
+
   if (header.GetDest () == GetAddress () || header.GetDest () == LoraAddress::GetBroadcast ())
     {
       m_forUpCb (pkt, header.GetSrc ());
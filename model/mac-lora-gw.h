@@ -58,6 +58,19 @@ public:
   virtual void Clear (void);
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * Set the callback reporting every frame decoded by this MAC,
+   * whatever its destination.
+   *
+   * Used by a network server to collect the uplinks received by a
+   * gateway.  The callback gets a copy of the packet without the
+   * common header, the source address, the SINR of the reception
+   * and the address of this MAC.
+   *
+   * \param cb The callback.
+   */
+  void SetUplinkCallback (Callback<void, Ptr<Packet>, const LoraAddress&, double, const LoraAddress& > cb);
+
 private:
   /** The MAC address. */
   LoraAddress m_address;
@@ -65,6 +78,10 @@ private:
   Ptr<LoraPhy> m_phy;
   /** Forwarding up callback. */
   Callback<void, Ptr<Packet>, const LoraAddress& > m_forUpCb;
+  /** Uplink reporting callback. */
+  Callback<void, Ptr<Packet>, const LoraAddress&, double, const LoraAddress& > m_uplinkCb;
+  /** Frame counter of the next frame sent. */
+  uint16_t m_frameCounter;
   /** Flag when we've been cleared. */
   bool m_cleared;
 
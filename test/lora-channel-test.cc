@@ -0,0 +1,913 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/lora-net-device.h"
+#include "ns3/lora-channel.h"
+#include "ns3/lora-phy-gen.h"
+#include "ns3/lora-transducer-hd.h"
+#include "ns3/lora-prop-model-thorp.h"
+#include "ns3/mac-lora-gw.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * Transducer recording the arrivals the channel delivers to it and the
+ * packets it transmits.
+ */
+class LoraRecordingTransducer : public LoraTransducerHd
+{
+public:
+  /** An arrival, as handed over by the channel. */
+  struct Arrival
+  {
+    uint32_t m_order;       //!< Delivery order among all the recorders.
+    Time m_time;            //!< Arrival time.
+    uint32_t m_context;     //!< Simulator context of the delivery.
+    double m_rxPowerDb;     //!< Received power, in dB.
+    Ptr<Packet> m_packet;   //!< The packet.
+  };
+
+  virtual void Receive (Ptr<Packet> packet, double rxPowerDb, LoraTxMode txMode, LoraPdp pdp)
+  {
+    Arrival arrival;
+    arrival.m_order = s_deliveries++;
+    arrival.m_time = Simulator::Now ();
+    arrival.m_context = Simulator::GetContext ();
+    arrival.m_rxPowerDb = rxPowerDb;
+    arrival.m_packet = packet;
+    m_arrivals.push_back (arrival);
+    LoraTransducerHd::Receive (packet, rxPowerDb, txMode, pdp);
+  }
+
+  virtual void Transmit (Ptr<LoraPhy> src, Ptr<Packet> packet, double txPowerDb, LoraTxMode txMode)
+  {
+    m_sent.push_back (packet);
+    LoraTransducerHd::Transmit (src, packet, txPowerDb, txMode);
+  }
+
+  std::vector<Arrival> m_arrivals;  //!< Arrivals, in delivery order.
+  std::vector<Ptr<Packet> > m_sent; //!< Transmitted packets.
+  static uint32_t s_deliveries;     //!< Deliveries to all the recorders.
+};
+
+uint32_t LoraRecordingTransducer::s_deliveries = 0;
+
+/**
+ * Base of the channel tests: builds devices whose transducers record
+ * what the channel delivers.
+ */
+class LoraChannelTestCase : public TestCase
+{
+public:
+  /**
+   * \param name Test name.
+   */
+  LoraChannelTestCase (std::string name);
+
+protected:
+  /**
+   * Get the test mode of a center frequency, 300 bps over 125 Hz.
+   *
+   * \param freqHz Center frequency, in Hz.
+   * \return The mode.
+   */
+  static LoraTxMode GetTestMode (uint32_t freqHz);
+  /**
+   * Create a device on its own node.
+   *
+   * \param chan The channel.
+   * \param pos Position of the node.
+   * \param mode Single mode of the PHY.
+   * \return The device.
+   */
+  Ptr<LoraNetDevice> CreateDevice (Ptr<LoraChannel> chan, Vector pos, LoraTxMode mode);
+  /**
+   * Get the recording transducer of a device.
+   *
+   * \param dev The device.
+   * \return The transducer.
+   */
+  static Ptr<LoraRecordingTransducer> GetRecorder (Ptr<LoraNetDevice> dev);
+  /**
+   * Broadcast a 13 byte packet.
+   *
+   * \param dev The sending device.
+   */
+  static void Send (Ptr<LoraNetDevice> dev);
+  /**
+   * Move a device.
+   *
+   * \param dev The device.
+   * \param pos The new position.
+   */
+  static void Move (Ptr<LoraNetDevice> dev, Vector pos);
+};
+
+LoraChannelTestCase::LoraChannelTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+LoraTxMode
+LoraChannelTestCase::GetTestMode (uint32_t freqHz)
+{
+  std::ostringstream name;
+  name << "ChannelTestMode" << freqHz;
+  return LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, freqHz, 125, 2, name.str ());
+}
+
+Ptr<LoraNetDevice>
+LoraChannelTestCase::CreateDevice (Ptr<LoraChannel> chan, Vector pos, LoraTxMode mode)
+{
+  LoraModesList modes;
+  modes.AppendMode (mode);
+  Ptr<LoraPhyGen> phy = CreateObject<LoraPhyGen> ();
+  phy->SetAttribute ("SupportedModes", LoraModesListValue (modes));
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<LoraNetDevice> dev = CreateObject<LoraNetDevice> ();
+  Ptr<MacLoraAca> mac = CreateObject<MacLoraAca> ();
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (LoraAddress::Allocate ());
+
+  dev->SetPhy (phy);
+  dev->SetMac (mac);
+  dev->SetChannel (chan);
+  dev->SetTransducer (CreateObject<LoraRecordingTransducer> ());
+  node->AddDevice (dev);
+  return dev;
+}
+
+Ptr<LoraRecordingTransducer>
+LoraChannelTestCase::GetRecorder (Ptr<LoraNetDevice> dev)
+{
+  return DynamicCast<LoraRecordingTransducer> (dev->GetTransducer ());
+}
+
+void
+LoraChannelTestCase::Send (Ptr<LoraNetDevice> dev)
+{
+  dev->Send (Create<Packet> (13), dev->GetBroadcast (), 0);
+}
+
+void
+LoraChannelTestCase::Move (Ptr<LoraNetDevice> dev, Vector pos)
+{
+  dev->GetNode ()->GetObject<MobilityModel> ()->SetPosition (pos);
+}
+
+
+/**
+ * Spatial culling: receivers just inside and just outside the range of
+ * the propagation model, and receivers crossing grid cells, get the
+ * same arrivals as with a full scan.
+ */
+class LoraChannelCullingTest : public LoraChannelTestCase
+{
+public:
+  LoraChannelCullingTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Run the scenario.
+   *
+   * \param cellSize Side of the grid cells, 0 for a full scan.
+   * \return Arrival times of each receiver.
+   */
+  std::vector<std::vector<Time> > Run (double cellSize);
+
+  double m_range;  //!< Range of the transmitter at the interference floor.
+};
+
+LoraChannelCullingTest::LoraChannelCullingTest ()
+  : LoraChannelTestCase ("LoRa channel spatial culling"),
+    m_range (0)
+{
+}
+
+std::vector<std::vector<Time> >
+LoraChannelCullingTest::Run (double cellSize)
+{
+  LoraTxMode mode = GetTestMode (10000);
+  Ptr<LoraChannel> channel = CreateObject<LoraChannel> ();
+  channel->SetAttribute ("PropagationModel", PointerValue (CreateObject<LoraPropModelThorp> ()));
+  channel->SetAttribute ("InterferenceFloor", DoubleValue (190 - 50));
+  channel->SetAttribute ("SpatialIndexCellSize", DoubleValue (cellSize));
+
+  double r = m_range;
+  Ptr<LoraNetDevice> tx = CreateDevice (channel, Vector (0, 0, 0), mode);
+  std::vector<Ptr<LoraNetDevice> > rx;
+  rx.push_back (CreateDevice (channel, Vector (r - 1, 0, 0), mode));        // inside
+  rx.push_back (CreateDevice (channel, Vector (0, -(r + 1), 0), mode));     // outside
+  rx.push_back (CreateDevice (channel, Vector (3 * r, 3 * r, 0), mode));    // moves in
+  rx.push_back (CreateDevice (channel, Vector (0, r - 1, 0), mode));        // moves out
+
+  Simulator::Schedule (Seconds (1), &LoraChannelTestCase::Send, tx);
+  Simulator::Schedule (Seconds (2), &LoraChannelTestCase::Move, rx[2], Vector (-(r - 1), 0, 0));
+  Simulator::Schedule (Seconds (2), &LoraChannelTestCase::Move, rx[3], Vector (0, r + 1, 0));
+  Simulator::Schedule (Seconds (4), &LoraChannelTestCase::Send, tx);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  std::vector<std::vector<Time> > times (rx.size ());
+  for (uint32_t i = 0; i < rx.size (); i++)
+    {
+      const std::vector<LoraRecordingTransducer::Arrival> &arrivals = GetRecorder (rx[i])->m_arrivals;
+      for (uint32_t k = 0; k < arrivals.size (); k++)
+        {
+          times[i].push_back (arrivals[k].m_time);
+        }
+    }
+  Simulator::Destroy ();
+  return times;
+}
+
+void
+LoraChannelCullingTest::DoRun (void)
+{
+  Ptr<LoraPropModelThorp> prop = CreateObject<LoraPropModelThorp> ();
+  m_range = prop->GetMaxRangeM (50, GetTestMode (10000));
+  NS_TEST_ASSERT_MSG_GT (m_range, 10, "Range too short for the scenario");
+
+  // Cells of a third of the range: the moving receivers change cells.
+  std::vector<std::vector<Time> > grid = Run (m_range / 3);
+  std::vector<std::vector<Time> > scan = Run (0);
+
+  NS_TEST_ASSERT_MSG_EQ (grid[0].size (), 2, "Receiver inside the range culled");
+  NS_TEST_ASSERT_MSG_EQ (grid[1].size (), 0, "Receiver outside the range reached");
+  NS_TEST_ASSERT_MSG_EQ (grid[2].size (), 1, "Receiver moving into range not found in its new cell");
+  NS_TEST_ASSERT_MSG_EQ (grid[3].size (), 1, "Receiver moving out of range still reached");
+  for (uint32_t i = 0; i < grid.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (grid[i].size (), scan[i].size (), "Culling changed the arrivals of receiver " << i);
+      for (uint32_t k = 0; k < grid[i].size (); k++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (grid[i][k], scan[i][k], "Culling changed an arrival time of receiver " << i);
+        }
+    }
+}
+
+
+/**
+ * Link budget cache: a CourseChange at either end of a link drops its
+ * cached budget, and links of devices which did not move stay valid.
+ */
+class LoraChannelLinkCacheTest : public LoraChannelTestCase
+{
+public:
+  LoraChannelLinkCacheTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Run the scenario.
+   *
+   * \param cache Whether to cache the link budgets.
+   * \return Received powers of each device, in dB.
+   */
+  std::vector<std::vector<double> > Run (bool cache);
+};
+
+LoraChannelLinkCacheTest::LoraChannelLinkCacheTest ()
+  : LoraChannelTestCase ("LoRa channel link budget cache invalidation")
+{
+}
+
+std::vector<std::vector<double> >
+LoraChannelLinkCacheTest::Run (bool cache)
+{
+  LoraTxMode mode = GetTestMode (10000);
+  Ptr<LoraChannel> channel = CreateObject<LoraChannel> ();
+  channel->SetAttribute ("PropagationModel", PointerValue (CreateObject<LoraPropModelThorp> ()));
+  channel->SetAttribute ("LinkBudgetCache", BooleanValue (cache));
+
+  std::vector<Ptr<LoraNetDevice> > devs;
+  devs.push_back (CreateDevice (channel, Vector (0, 0, 0), mode));
+  devs.push_back (CreateDevice (channel, Vector (100, 0, 0), mode));
+  devs.push_back (CreateDevice (channel, Vector (200, 0, 0), mode));
+
+  // The receiver moves, then the transmitter of the cached links.
+  Simulator::Schedule (Seconds (1), &LoraChannelTestCase::Send, devs[0]);
+  Simulator::Schedule (Seconds (2), &LoraChannelTestCase::Move, devs[1], Vector (0, 300, 0));
+  Simulator::Schedule (Seconds (3), &LoraChannelTestCase::Send, devs[0]);
+  Simulator::Schedule (Seconds (4), &LoraChannelTestCase::Send, devs[1]);
+  Simulator::Schedule (Seconds (5), &LoraChannelTestCase::Move, devs[0], Vector (50, 0, 0));
+  Simulator::Schedule (Seconds (6), &LoraChannelTestCase::Send, devs[1]);
+  Simulator::Schedule (Seconds (7), &LoraChannelTestCase::Send, devs[0]);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  std::vector<std::vector<double> > powers (devs.size ());
+  for (uint32_t i = 0; i < devs.size (); i++)
+    {
+      const std::vector<LoraRecordingTransducer::Arrival> &arrivals = GetRecorder (devs[i])->m_arrivals;
+      for (uint32_t k = 0; k < arrivals.size (); k++)
+        {
+          powers[i].push_back (arrivals[k].m_rxPowerDb);
+        }
+    }
+  Simulator::Destroy ();
+  return powers;
+}
+
+void
+LoraChannelLinkCacheTest::DoRun (void)
+{
+  LoraTxMode mode = GetTestMode (10000);
+  Ptr<LoraPropModelThorp> prop = CreateObject<LoraPropModelThorp> ();
+  double txPowerDb = 190;
+
+  std::vector<std::vector<double> > cached = Run (true);
+  std::vector<std::vector<double> > direct = Run (false);
+
+  NS_TEST_ASSERT_MSG_EQ (cached[0].size (), 2, "Wrong number of arrivals at A");
+  NS_TEST_ASSERT_MSG_EQ (cached[1].size (), 3, "Wrong number of arrivals at B");
+  NS_TEST_ASSERT_MSG_EQ (cached[2].size (), 5, "Wrong number of arrivals at C");
+
+  // Receiver moved.
+  NS_TEST_ASSERT_MSG_EQ_TOL (cached[1][1],
+                             txPowerDb - prop->GetPathLossDbFromPositions (Vector (0, 0, 0), Vector (0, 300, 0), mode),
+                             1e-9, "Stale budget after the receiver moved");
+  // Transmitter moved, as receiver of B and then as transmitter.
+  NS_TEST_ASSERT_MSG_EQ_TOL (cached[0][1],
+                             txPowerDb - prop->GetPathLossDbFromPositions (Vector (0, 300, 0), Vector (50, 0, 0), mode),
+                             1e-9, "Stale budget after the transmitter moved");
+  NS_TEST_ASSERT_MSG_EQ_TOL (cached[1][2],
+                             txPowerDb - prop->GetPathLossDbFromPositions (Vector (50, 0, 0), Vector (0, 300, 0), mode),
+                             1e-9, "Stale budget after the transmitter moved");
+  NS_TEST_ASSERT_MSG_EQ_TOL (cached[2][4],
+                             txPowerDb - prop->GetPathLossDbFromPositions (Vector (50, 0, 0), Vector (200, 0, 0), mode),
+                             1e-9, "Stale budget after the transmitter moved");
+  // Neither end moved.
+  NS_TEST_ASSERT_MSG_EQ_TOL (cached[2][1], cached[2][0], 1e-9, "Budget of an unchanged link dropped");
+  NS_TEST_ASSERT_MSG_EQ_TOL (cached[2][3], cached[2][2], 1e-9, "Budget of an unchanged link dropped");
+
+  for (uint32_t i = 0; i < cached.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (cached[i].size (), direct[i].size (), "Cache changed the arrivals of device " << i);
+      for (uint32_t k = 0; k < cached[i].size (); k++)
+        {
+          NS_TEST_ASSERT_MSG_EQ_TOL (cached[i][k], direct[i][k], 1e-9,
+                                     "Cache changed a received power of device " << i);
+        }
+    }
+}
+
+
+/**
+ * Fan-out dispatch: arrival order, arrival times and node contexts are
+ * the same as with one event per receiver.
+ */
+class LoraChannelFanOutTest : public LoraChannelTestCase
+{
+public:
+  LoraChannelFanOutTest ();
+
+  virtual void DoRun (void);
+private:
+  /** A delivery, in the order of all the deliveries of a run. */
+  struct Delivery
+  {
+    uint32_t m_order;     //!< Delivery order.
+    uint32_t m_dev;       //!< Receiving device.
+    Time m_time;          //!< Arrival time.
+    uint32_t m_context;   //!< Simulator context of the delivery.
+    uint32_t m_nodeId;    //!< Node of the receiving device.
+  };
+  /**
+   * Order deliveries.
+   *
+   * \param a First delivery.
+   * \param b Second delivery.
+   * 
+eturn True if a was delivered before b.
+   */
+  static bool DeliveredBefore (const Delivery &a, const Delivery &b);
+  /**
+   * Run the scenario.
+   *
+   * \param fanOut Whether to dispatch through a single event per transmission.
+   * 
+eturn All the deliveries, in delivery order.
+   */
+  std::vector<Delivery> Run (bool fanOut);
+};
+
+LoraChannelFanOutTest::LoraChannelFanOutTest ()
+  : LoraChannelTestCase ("LoRa channel fan-out dispatch")
+{
+}
+
+bool
+LoraChannelFanOutTest::DeliveredBefore (const Delivery &a, const Delivery &b)
+{
+  return a.m_order < b.m_order;
+}
+
+std::vector<LoraChannelFanOutTest::Delivery>
+LoraChannelFanOutTest::Run (bool fanOut)
+{
+  LoraTxMode mode = GetTestMode (10000);
+  Ptr<LoraChannel> channel = CreateObject<LoraChannel> ();
+  channel->SetAttribute ("PropagationModel", PointerValue (CreateObject<LoraPropModelThorp> ()));
+  channel->SetAttribute ("FanOutDispatch", BooleanValue (fanOut));
+
+  std::vector<Ptr<LoraNetDevice> > devs;
+  devs.push_back (CreateDevice (channel, Vector (0, 0, 0), mode));
+  devs.push_back (CreateDevice (channel, Vector (300, 0, 0), mode));
+  devs.push_back (CreateDevice (channel, Vector (100, 0, 0), mode));
+  devs.push_back (CreateDevice (channel, Vector (0, 100, 0), mode));    // same distance
+  devs.push_back (CreateDevice (channel, Vector (200, 0, 0), mode));
+  devs.push_back (CreateDevice (channel, Vector (400, 0, 0), mode));
+
+  // Two transmissions whose arrivals interleave.
+  Simulator::Schedule (Seconds (1), &LoraChannelTestCase::Send, devs[0]);
+  Simulator::Schedule (Seconds (1.05), &LoraChannelTestCase::Send, devs[5]);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  std::vector<Delivery> deliveries;
+  for (uint32_t i = 0; i < devs.size (); i++)
+    {
+      const std::vector<LoraRecordingTransducer::Arrival> &arrivals = GetRecorder (devs[i])->m_arrivals;
+      for (uint32_t k = 0; k < arrivals.size (); k++)
+        {
+          Delivery delivery;
+          delivery.m_order = arrivals[k].m_order;
+          delivery.m_dev = i;
+          delivery.m_time = arrivals[k].m_time;
+          delivery.m_context = arrivals[k].m_context;
+          delivery.m_nodeId = devs[i]->GetNode ()->GetId ();
+          deliveries.push_back (delivery);
+        }
+    }
+  std::sort (deliveries.begin (), deliveries.end (), &LoraChannelFanOutTest::DeliveredBefore);
+  Simulator::Destroy ();
+  return deliveries;
+}
+
+void
+LoraChannelFanOutTest::DoRun (void)
+{
+  std::vector<Delivery> events = Run (false);
+  std::vector<Delivery> fanOut = Run (true);
+
+  NS_TEST_ASSERT_MSG_EQ (events.size (), 10, "Wrong number of deliveries");
+  NS_TEST_ASSERT_MSG_EQ (fanOut.size (), events.size (), "Fan-out changed the number of deliveries");
+  for (uint32_t k = 0; k < fanOut.size () && k < events.size (); k++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (fanOut[k].m_dev, events[k].m_dev, "Fan-out changed the arrival order at " << k);
+      NS_TEST_ASSERT_MSG_EQ (fanOut[k].m_time, events[k].m_time, "Fan-out changed the arrival time at " << k);
+      NS_TEST_ASSERT_MSG_EQ (fanOut[k].m_context, events[k].m_context, "Fan-out changed the context at " << k);
+      NS_TEST_ASSERT_MSG_EQ (fanOut[k].m_context, fanOut[k].m_nodeId, "Delivery out of the receiver context at " << k);
+    }
+}
+
+
+/**
+ * Shared arrivals: all the receivers of a transmission get the same
+ * packet, which neither the sender nor the decoding receivers modify.
+ */
+class LoraChannelSharedPacketTest : public LoraChannelTestCase
+{
+public:
+  LoraChannelSharedPacketTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Record the size of the last packet sent by a device, then add
+   * bytes to it.
+   *
+   * \param dev The sending device.
+   */
+  void GrowSent (Ptr<LoraNetDevice> dev);
+  /**
+   * Count a successful reception.
+   *
+   * \param packet The packet.
+   * \param sinr The SINR.
+   * \param mode The mode.
+   */
+  void RxOk (Ptr<const Packet> packet, double sinr, LoraTxMode mode);
+
+  uint32_t m_sentSize;  //!< Size of the sent packet at transmission.
+  uint32_t m_rxOk;      //!< Number of successful receptions.
+};
+
+LoraChannelSharedPacketTest::LoraChannelSharedPacketTest ()
+  : LoraChannelTestCase ("LoRa channel shared arrivals"),
+    m_sentSize (0),
+    m_rxOk (0)
+{
+}
+
+void
+LoraChannelSharedPacketTest::GrowSent (Ptr<LoraNetDevice> dev)
+{
+  Ptr<Packet> sent = GetRecorder (dev)->m_sent.back ();
+  m_sentSize = sent->GetSize ();
+  sent->AddPaddingAtEnd (7);
+}
+
+void
+LoraChannelSharedPacketTest::RxOk (Ptr<const Packet> packet, double sinr, LoraTxMode mode)
+{
+  m_rxOk++;
+}
+
+void
+LoraChannelSharedPacketTest::DoRun (void)
+{
+  LoraTxMode mode = GetTestMode (10000);
+  Ptr<LoraChannel> channel = CreateObject<LoraChannel> ();
+  channel->SetAttribute ("PropagationModel", PointerValue (CreateObject<LoraPropModelThorp> ()));
+
+  Ptr<LoraNetDevice> tx = CreateDevice (channel, Vector (0, 0, 0), mode);
+  std::vector<Ptr<LoraNetDevice> > rx;
+  for (uint32_t i = 1; i <= 3; i++)
+    {
+      rx.push_back (CreateDevice (channel, Vector (100 * i, 0, 0), mode));
+      rx.back ()->GetPhy ()->TraceConnectWithoutContext
+        ("RxOk", MakeCallback (&LoraChannelSharedPacketTest::RxOk, this));
+    }
+
+  Simulator::Schedule (Seconds (1), &LoraChannelTestCase::Send, tx);
+  // The sender modifies its packet before the first arrival.
+  Simulator::Schedule (Seconds (1.01), &LoraChannelSharedPacketTest::GrowSent, this, tx);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (GetRecorder (tx)->m_sent.size (), 1, "Wrong number of transmissions");
+  NS_TEST_ASSERT_MSG_EQ (m_rxOk, rx.size (), "All the receivers should decode the packet");
+  Ptr<Packet> sent = GetRecorder (tx)->m_sent.front ();
+  Ptr<Packet> shared = GetRecorder (rx[0])->m_arrivals.front ().m_packet;
+  NS_TEST_ASSERT_MSG_NE (shared, sent, "Receivers share the packet of the sender");
+  NS_TEST_ASSERT_MSG_EQ (shared->GetSize (), m_sentSize, "Arrival modified after transmission");
+  for (uint32_t i = 0; i < rx.size (); i++)
+    {
+      const std::vector<LoraRecordingTransducer::Arrival> &arrivals = GetRecorder (rx[i])->m_arrivals;
+      NS_TEST_ASSERT_MSG_EQ (arrivals.size (), 1, "Wrong number of arrivals at receiver " << i);
+      NS_TEST_ASSERT_MSG_EQ (arrivals.front ().m_packet, shared, "Receiver " << i << " got its own copy");
+    }
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Devices attached after the first transmissions are indexed, culled,
+ * cached and tracked like the others.
+ */
+class LoraChannelLateDeviceTest : public LoraChannelTestCase
+{
+public:
+  LoraChannelLateDeviceTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Attach a device to the channel.
+   *
+   * \param chan The channel.
+   * \param pos Position of the device.
+   */
+  void AddLate (Ptr<LoraChannel> chan, Vector pos);
+  /** Broadcast from the late device. */
+  void SendLate (void);
+  /**
+   * Move the late device.
+   *
+   * \param pos The new position.
+   */
+  void MoveLate (Vector pos);
+
+  Ptr<LoraNetDevice> m_late;  //!< The device attached during the run.
+};
+
+LoraChannelLateDeviceTest::LoraChannelLateDeviceTest ()
+  : LoraChannelTestCase ("LoRa channel devices attached during a run")
+{
+}
+
+void
+LoraChannelLateDeviceTest::AddLate (Ptr<LoraChannel> chan, Vector pos)
+{
+  m_late = CreateDevice (chan, pos, GetTestMode (10000));
+}
+
+void
+LoraChannelLateDeviceTest::SendLate (void)
+{
+  Send (m_late);
+}
+
+void
+LoraChannelLateDeviceTest::MoveLate (Vector pos)
+{
+  Move (m_late, pos);
+}
+
+void
+LoraChannelLateDeviceTest::DoRun (void)
+{
+  LoraTxMode mode = GetTestMode (10000);
+  Ptr<LoraPropModelThorp> prop = CreateObject<LoraPropModelThorp> ();
+  Ptr<LoraChannel> channel = CreateObject<LoraChannel> ();
+  channel->SetAttribute ("PropagationModel", PointerValue (prop));
+  channel->SetAttribute ("InterferenceFloor", DoubleValue (190 - 60));
+  channel->SetAttribute ("SpatialIndexCellSize", DoubleValue (1000));
+  channel->SetAttribute ("LinkBudgetCache", BooleanValue (true));
+
+  Ptr<LoraNetDevice> a = CreateDevice (channel, Vector (0, 0, 0), mode);
+  Ptr<LoraNetDevice> b = CreateDevice (channel, Vector (100, 0, 0), mode);
+
+  Simulator::Schedule (Seconds (1), &LoraChannelTestCase::Send, a);
+  Simulator::Schedule (Seconds (2), &LoraChannelLateDeviceTest::AddLate, this, channel, Vector (0, 200, 0));
+  Simulator::Schedule (Seconds (3), &LoraChannelLateDeviceTest::SendLate, this);
+  Simulator::Schedule (Seconds (4), &LoraChannelTestCase::Send, a);
+  Simulator::Schedule (Seconds (5), &LoraChannelLateDeviceTest::MoveLate, this, Vector (0, 400, 0));
+  Simulator::Schedule (Seconds (6), &LoraChannelTestCase::Send, a);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (GetRecorder (a)->m_arrivals.size (), 1, "Transmission of the late device not received");
+  NS_TEST_ASSERT_MSG_EQ (GetRecorder (b)->m_arrivals.size (), 4, "Wrong number of arrivals at the early receiver");
+  const std::vector<LoraRecordingTransducer::Arrival> &late = GetRecorder (m_late)->m_arrivals;
+  NS_TEST_ASSERT_MSG_EQ (late.size (), 2, "Late device not reached");
+  NS_TEST_ASSERT_MSG_EQ_TOL (late[0].m_rxPowerDb,
+                             190 - prop->GetPathLossDbFromPositions (Vector (0, 0, 0), Vector (0, 200, 0), mode),
+                             1e-9, "Wrong received power at the late device");
+  NS_TEST_ASSERT_MSG_EQ_TOL (late[1].m_rxPowerDb,
+                             190 - prop->GetPathLossDbFromPositions (Vector (0, 0, 0), Vector (0, 400, 0), mode),
+                             1e-9, "Course change of the late device not tracked");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Receive roles: the channel skips sleeping RX_WHEN_AWAKE devices and
+ * RX_NEVER devices, and follows role changes after attach.
+ */
+class LoraChannelRoleTest : public LoraChannelTestCase
+{
+public:
+  LoraChannelRoleTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Change the receive role of a device.
+   *
+   * \param dev The device.
+   * \param role The new role.
+   */
+  static void SetRole (Ptr<LoraNetDevice> dev, LoraNetDevice::ReceiveRole role);
+};
+
+LoraChannelRoleTest::LoraChannelRoleTest ()
+  : LoraChannelTestCase ("LoRa channel receive roles")
+{
+}
+
+void
+LoraChannelRoleTest::SetRole (Ptr<LoraNetDevice> dev, LoraNetDevice::ReceiveRole role)
+{
+  dev->SetReceiveRole (role);
+}
+
+void
+LoraChannelRoleTest::DoRun (void)
+{
+  LoraTxMode mode = GetTestMode (10000);
+  Ptr<LoraChannel> channel = CreateObject<LoraChannel> ();
+  channel->SetAttribute ("PropagationModel", PointerValue (CreateObject<LoraPropModelThorp> ()));
+
+  Ptr<LoraNetDevice> tx = CreateDevice (channel, Vector (0, 0, 0), mode);
+  Ptr<LoraNetDevice> always = CreateDevice (channel, Vector (100, 0, 0), mode);
+  Ptr<LoraNetDevice> awake = CreateDevice (channel, Vector (0, 100, 0), mode);
+  awake->SetReceiveRole (LoraNetDevice::RX_WHEN_AWAKE);
+  Ptr<LoraNetDevice> asleep = CreateDevice (channel, Vector (-100, 0, 0), mode);
+  asleep->SetReceiveRole (LoraNetDevice::RX_WHEN_AWAKE);
+  asleep->GetPhy ()->SetSleepMode (true);
+  Ptr<LoraNetDevice> never = CreateDevice (channel, Vector (0, -100, 0), mode);
+  never->SetReceiveRole (LoraNetDevice::RX_NEVER);
+  Ptr<LoraNetDevice> joining = CreateDevice (channel, Vector (-200, 0, 0), mode);
+  joining->SetReceiveRole (LoraNetDevice::RX_NEVER);
+
+  Simulator::Schedule (Seconds (1), &LoraChannelTestCase::Send, tx);
+  Simulator::Schedule (Seconds (2), &LoraChannelRoleTest::SetRole, joining, LoraNetDevice::RX_ALWAYS);
+  Simulator::Schedule (Seconds (3), &LoraChannelTestCase::Send, tx);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (GetRecorder (always)->m_arrivals.size (), 2, "RX_ALWAYS device skipped");
+  NS_TEST_ASSERT_MSG_EQ (GetRecorder (awake)->m_arrivals.size (), 2, "Awake RX_WHEN_AWAKE device skipped");
+  NS_TEST_ASSERT_MSG_EQ (GetRecorder (asleep)->m_arrivals.size (), 0, "Sleeping RX_WHEN_AWAKE device reached");
+  NS_TEST_ASSERT_MSG_EQ (GetRecorder (never)->m_arrivals.size (), 0, "RX_NEVER device reached");
+  NS_TEST_ASSERT_MSG_EQ (GetRecorder (joining)->m_arrivals.size (), 1, "Role change after attach ignored");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Frequency filter: the channel skips devices whose PHY has no mode
+ * overlapping the band of a transmission, and follows PHY changes after
+ * attach.
+ */
+class LoraChannelBandFilterTest : public LoraChannelTestCase
+{
+public:
+  LoraChannelBandFilterTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Give a device a new PHY.
+   *
+   * \param dev The device.
+   * \param mode Single mode of the new PHY.
+   */
+  static void SwapPhy (Ptr<LoraNetDevice> dev, LoraTxMode mode);
+};
+
+LoraChannelBandFilterTest::LoraChannelBandFilterTest ()
+  : LoraChannelTestCase ("LoRa channel frequency filter")
+{
+}
+
+void
+LoraChannelBandFilterTest::SwapPhy (Ptr<LoraNetDevice> dev, LoraTxMode mode)
+{
+  LoraModesList modes;
+  modes.AppendMode (mode);
+  Ptr<LoraPhyGen> phy = CreateObject<LoraPhyGen> ();
+  phy->SetAttribute ("SupportedModes", LoraModesListValue (modes));
+  dev->SetPhy (phy);
+}
+
+void
+LoraChannelBandFilterTest::DoRun (void)
+{
+  LoraTxMode inBand = GetTestMode (10000);
+  LoraTxMode offBand = GetTestMode (20000);
+  Ptr<LoraChannel> channel = CreateObject<LoraChannel> ();
+  channel->SetAttribute ("PropagationModel", PointerValue (CreateObject<LoraPropModelThorp> ()));
+  channel->SetAttribute ("FrequencyFilter", BooleanValue (true));
+
+  Ptr<LoraNetDevice> tx = CreateDevice (channel, Vector (0, 0, 0), inBand);
+  Ptr<LoraNetDevice> same = CreateDevice (channel, Vector (100, 0, 0), inBand);
+  Ptr<LoraNetDevice> other = CreateDevice (channel, Vector (0, 100, 0), offBand);
+  Ptr<LoraNetDevice> retuned = CreateDevice (channel, Vector (-100, 0, 0), offBand);
+
+  Simulator::Schedule (Seconds (1), &LoraChannelTestCase::Send, tx);
+  Simulator::Schedule (Seconds (2), &LoraChannelBandFilterTest::SwapPhy, retuned, inBand);
+  Simulator::Schedule (Seconds (3), &LoraChannelTestCase::Send, tx);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (GetRecorder (same)->m_arrivals.size (), 2, "Device in the band skipped");
+  NS_TEST_ASSERT_MSG_EQ (GetRecorder (other)->m_arrivals.size (), 0, "Device in another band reached");
+  const std::vector<LoraRecordingTransducer::Arrival> &arrivals = GetRecorder (retuned)->m_arrivals;
+  NS_TEST_ASSERT_MSG_EQ (arrivals.size (), 1, "PHY change after attach ignored");
+  NS_TEST_ASSERT_MSG_GT (arrivals.front ().m_time, Seconds (3), "Device reached before its PHY changed");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Parallel link budgets: the arrivals computed on the worker pool are
+ * those of the sequential path.
+ */
+class LoraChannelParallelTest : public LoraChannelTestCase
+{
+public:
+  LoraChannelParallelTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Run the scenario.
+   *
+   * \param threads Number of threads computing the link budgets.
+   * \return All the arrivals, by receiver.
+   */
+  std::vector<std::vector<LoraRecordingTransducer::Arrival> > Run (uint32_t threads);
+};
+
+LoraChannelParallelTest::LoraChannelParallelTest ()
+  : LoraChannelTestCase ("LoRa channel parallel link budgets")
+{
+}
+
+std::vector<std::vector<LoraRecordingTransducer::Arrival> >
+LoraChannelParallelTest::Run (uint32_t threads)
+{
+  LoraTxMode mode = GetTestMode (10000);
+  Ptr<LoraChannel> channel = CreateObject<LoraChannel> ();
+  channel->SetAttribute ("PropagationModel", PointerValue (CreateObject<LoraPropModelThorp> ()));
+  channel->SetAttribute ("ParallelThreads", UintegerValue (threads));
+  channel->SetAttribute ("ParallelThreshold", UintegerValue (1));
+
+  std::vector<Ptr<LoraNetDevice> > devs;
+  for (uint32_t k = 0; k < 40; k++)
+    {
+      devs.push_back (CreateDevice (channel, Vector ((k % 8) * 37.0 + 5, (k / 8) * 53.0 + 11, 0), mode));
+    }
+
+  Simulator::Schedule (Seconds (1), &LoraChannelTestCase::Send, devs[0]);
+  Simulator::Schedule (Seconds (2), &LoraChannelTestCase::Send, devs[27]);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  std::vector<std::vector<LoraRecordingTransducer::Arrival> > arrivals;
+  for (uint32_t k = 0; k < devs.size (); k++)
+    {
+      arrivals.push_back (GetRecorder (devs[k])->m_arrivals);
+    }
+  Simulator::Destroy ();
+  return arrivals;
+}
+
+void
+LoraChannelParallelTest::DoRun (void)
+{
+  std::vector<std::vector<LoraRecordingTransducer::Arrival> > parallel = Run (4);
+  std::vector<std::vector<LoraRecordingTransducer::Arrival> > sequential = Run (1);
+
+  for (uint32_t i = 0; i < parallel.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].size (), (i == 0 || i == 27) ? 1 : 2,
+                             "Wrong number of arrivals at receiver " << i);
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].size (), sequential[i].size (),
+                             "Threads changed the arrivals of receiver " << i);
+      for (uint32_t k = 0; k < parallel[i].size (); k++)
+        {
+          NS_TEST_ASSERT_MSG_EQ_TOL (parallel[i][k].m_time, sequential[i][k].m_time, NanoSeconds (1),
+                                     "Threads changed an arrival time of receiver " << i);
+          NS_TEST_ASSERT_MSG_EQ_TOL (parallel[i][k].m_rxPowerDb, sequential[i][k].m_rxPowerDb, 1e-9,
+                                     "Threads changed a received power of receiver " << i);
+        }
+    }
+  // Arrival order over all the receivers.
+  for (uint32_t i = 0; i < parallel.size (); i++)
+    {
+      for (uint32_t k = 0; k < parallel[i].size (); k++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (parallel[i][k].m_order - parallel[0][0].m_order,
+                                 sequential[i][k].m_order - sequential[0][0].m_order,
+                                 "Threads changed the delivery order at receiver " << i);
+        }
+    }
+}
+
+
+/**
+ * LoRa channel test suite.
+ */
+class LoraChannelTestSuite : public TestSuite
+{
+public:
+  LoraChannelTestSuite ();
+};
+
+LoraChannelTestSuite::LoraChannelTestSuite ()
+  : TestSuite ("lora-channel", UNIT)
+{
+  AddTestCase (new LoraChannelCullingTest, TestCase::QUICK);
+  AddTestCase (new LoraChannelLinkCacheTest, TestCase::QUICK);
+  AddTestCase (new LoraChannelFanOutTest, TestCase::QUICK);
+  AddTestCase (new LoraChannelSharedPacketTest, TestCase::QUICK);
+  AddTestCase (new LoraChannelLateDeviceTest, TestCase::QUICK);
+  AddTestCase (new LoraChannelRoleTest, TestCase::QUICK);
+  AddTestCase (new LoraChannelBandFilterTest, TestCase::QUICK);
+  AddTestCase (new LoraChannelParallelTest, TestCase::QUICK);
+}
+
+static LoraChannelTestSuite g_loraChannelTestSuite;
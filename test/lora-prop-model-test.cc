@@ -0,0 +1,324 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/lora-prop-model.h"
+#include "ns3/lora-prop-model-ideal.h"
+#include "ns3/lora-prop-model-thorp.h"
+#include "ns3/lora-tx-mode.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Thorp model computing its link budgets through the default, per
+ * receiver, implementation of the base class.
+ */
+class LoraPropModelThorpDefaultBatch : public LoraPropModelThorp
+{
+public:
+  virtual void GetLinkBudgetsFromPositions (const Vector &sender,
+                                            const double *x, const double *y, const double *z,
+                                            uint32_t n, LoraTxMode mode,
+                                            double *lossDb, double *delayS)
+  {
+    LoraPropModel::GetLinkBudgetsFromPositions (sender, x, y, z, n, mode, lossDb, delayS);
+  }
+};
+
+/**
+ * Batched link budgets: pathloss and delay to each receiver are those
+ * of the per link calls on mobility models.
+ */
+class LoraPropModelBatchTest : public TestCase
+{
+public:
+  LoraPropModelBatchTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Compare the batch and the per link results of a model.
+   *
+   * \param prop The propagation model.
+   * \param name Name of the model, for the messages.
+   */
+  void Check (Ptr<LoraPropModel> prop, std::string name);
+};
+
+LoraPropModelBatchTest::LoraPropModelBatchTest ()
+  : TestCase ("LoRa batched link budgets")
+{
+}
+
+void
+LoraPropModelBatchTest::Check (Ptr<LoraPropModel> prop, std::string name)
+{
+  NS_TEST_ASSERT_MSG_EQ (prop->SupportsPositions (), true, name << " does not support positions");
+
+  Vector sender (12.5, -40, -3);
+  std::vector<double> x, y, z;
+  for (uint32_t k = 0; k < 37; k++)
+    {
+      // Distances from under a meter to tens of kilometers.
+      double scale = std::pow (10.0, (k % 6) - 1.0);
+      x.push_back (sender.x + scale * (1 + k % 5));
+      y.push_back (sender.y - scale * (k % 3));
+      z.push_back (sender.z + scale * 0.5 * (k % 2));
+    }
+  uint32_t n = x.size ();
+
+  LoraTxMode modes[] = {
+    LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10000, 125, 2, "BatchTestMode10k"),
+    LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 50000, 125, 2, "BatchTestMode50k")
+  };
+  for (uint32_t m = 0; m < 2; m++)
+    {
+      std::vector<double> lossDb (n);
+      std::vector<double> delayS (n);
+      prop->GetLinkBudgetsFromPositions (sender, &x[0], &y[0], &z[0], n, modes[m], &lossDb[0], &delayS[0]);
+
+      Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+      Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+      a->SetPosition (sender);
+      for (uint32_t k = 0; k < n; k++)
+        {
+          b->SetPosition (Vector (x[k], y[k], z[k]));
+          NS_TEST_ASSERT_MSG_EQ_TOL (lossDb[k], prop->GetPathLossDb (a, b, modes[m]), 1e-9,
+                                     name << ": wrong batch pathloss to receiver " << k);
+          NS_TEST_ASSERT_MSG_EQ_TOL (lossDb[k], prop->GetPathLossDbFromPositions (sender, b->GetPosition (), modes[m]), 1e-9,
+                                     name << ": wrong batch pathloss to receiver " << k);
+          // GetDelay is rounded to the time resolution.
+          NS_TEST_ASSERT_MSG_EQ_TOL (delayS[k], prop->GetDelay (a, b, modes[m]).GetSeconds (), 1e-9,
+                                     name << ": wrong batch delay to receiver " << k);
+          NS_TEST_ASSERT_MSG_EQ_TOL (delayS[k], prop->GetDelaySecondsFromPositions (sender, b->GetPosition (), modes[m]), 1e-12,
+                                     name << ": wrong batch delay to receiver " << k);
+        }
+    }
+}
+
+void
+LoraPropModelBatchTest::DoRun (void)
+{
+  Check (CreateObject<LoraPropModelIdeal> (), "Ideal");
+  Check (CreateObject<LoraPropModelThorp> (), "Thorp");
+  Check (CreateObject<LoraPropModelThorpDefaultBatch> (), "Default batch");
+}
+
+/**
+ * Shared LoraPdp tap storage: copies share the taps until one of them
+ * is changed, and the impulse profile is built only once.
+ */
+class LoraPdpSharingTest : public TestCase
+{
+public:
+  LoraPdpSharingTest ();
+
+  virtual void DoRun (void);
+};
+
+LoraPdpSharingTest::LoraPdpSharingTest ()
+  : TestCase ("LoRa PDP shared storage")
+{
+}
+
+void
+LoraPdpSharingTest::DoRun (void)
+{
+  LoraPdp a = LoraPdp::CreateImpulsePdp ();
+  LoraPdp b = LoraPdp::CreateImpulsePdp ();
+  NS_TEST_ASSERT_MSG_EQ (a.IsImpulse (), true, "Impulse PDP not flagged");
+  NS_TEST_ASSERT_MSG_EQ (&a.GetTap (0), &b.GetTap (0), "Impulse PDPs do not share their taps");
+
+  // Changing a copy of the impulse leaves the singleton alone.
+  b.SetTap (0.5, 0);
+  NS_TEST_ASSERT_MSG_EQ (b.IsImpulse (), false, "Changed impulse still flagged");
+  NS_TEST_ASSERT_MSG_NE (&a.GetTap (0), &b.GetTap (0), "Changed PDP still shares its taps");
+  NS_TEST_ASSERT_MSG_EQ (a.GetTap (0).GetAmp (), std::complex<double> (1.0), "Impulse changed through a copy");
+  LoraPdp c = LoraPdp::CreateImpulsePdp ();
+  NS_TEST_ASSERT_MSG_EQ (c.IsImpulse (), true, "Impulse singleton changed through a copy");
+  NS_TEST_ASSERT_MSG_EQ (&a.GetTap (0), &c.GetTap (0), "Impulse singleton rebuilt");
+  NS_TEST_ASSERT_MSG_EQ (LoraPdp (std::vector<double> (1, 1.0), Seconds (0)).IsImpulse (), true,
+                         "Unit impulse built from amplitudes not flagged");
+
+  std::vector<double> amps;
+  amps.push_back (0.25);
+  amps.push_back (1.0);
+  amps.push_back (0.5);
+  LoraPdp d (amps, MilliSeconds (1));
+  LoraPdp e = d;
+  LoraPdp f;
+  f = d;
+  NS_TEST_ASSERT_MSG_EQ (&d.GetTap (0), &e.GetTap (0), "Copy does not share the taps");
+  NS_TEST_ASSERT_MSG_EQ (&d.GetTap (0), &f.GetTap (0), "Assigned PDP does not share the taps");
+
+  // Each change on a copy detaches it from the others only.
+  e.SetTap (2.0, 2);
+  e.SetResolution (MilliSeconds (2));
+  f.SetNTaps (5);
+  NS_TEST_ASSERT_MSG_EQ (d.GetNTaps (), 3, "Original resized through a copy");
+  NS_TEST_ASSERT_MSG_EQ (d.GetResolution (), MilliSeconds (1), "Original resolution changed through a copy");
+  NS_TEST_ASSERT_MSG_EQ (d.GetTap (2).GetAmp (), std::complex<double> (0.5), "Original tap changed through a copy");
+  NS_TEST_ASSERT_MSG_EQ (d.GetPeakTapIndex (), 1, "Original peak changed through a copy");
+  NS_TEST_ASSERT_MSG_EQ (e.GetTap (2).GetAmp (), std::complex<double> (2.0), "Tap not changed");
+  NS_TEST_ASSERT_MSG_EQ (e.GetResolution (), MilliSeconds (2), "Resolution not changed");
+  NS_TEST_ASSERT_MSG_EQ (e.GetTap (1).GetDelay (), MilliSeconds (1), "Other taps not kept by the copy");
+  NS_TEST_ASSERT_MSG_EQ (e.GetPeakTapIndex (), 2, "Peak not updated");
+  NS_TEST_ASSERT_MSG_EQ (f.GetNTaps (), 5, "Copy not resized");
+  NS_TEST_ASSERT_MSG_EQ (e.GetNTaps (), 3, "Copy resized through another copy");
+
+  // The sole owner changes its storage in place.
+  const Tap *owned = &e.GetTap (0);
+  e.SetTap (0.75, 0);
+  NS_TEST_ASSERT_MSG_EQ (&e.GetTap (0), owned, "Unshared taps copied on change");
+}
+
+/**
+ * Cached peak tap and prefix sums of LoraPdp: the tap sums are those
+ * of a direct summation over the taps, also after the taps change.
+ */
+class LoraPdpSumsTest : public TestCase
+{
+public:
+  LoraPdpSumsTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Compare the tap sums of a PDP with a direct summation.
+   *
+   * \param pdp The PDP.
+   * \param name Name of the PDP, for the messages.
+   */
+  void Check (const LoraPdp &pdp, std::string name);
+};
+
+LoraPdpSumsTest::LoraPdpSumsTest ()
+  : TestCase ("LoRa PDP tap sums")
+{
+}
+
+void
+LoraPdpSumsTest::Check (const LoraPdp &pdp, std::string name)
+{
+  uint32_t n = pdp.GetNTaps ();
+  double res = pdp.GetResolution ().GetSeconds ();
+
+  double maxAmp = -1;
+  uint32_t peak = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (std::abs (pdp.GetTap (i).GetAmp ()) > maxAmp)
+        {
+          maxAmp = std::abs (pdp.GetTap (i).GetAmp ());
+          peak = i;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (pdp.GetPeakTapIndex (), peak, name << ": wrong peak tap");
+
+  for (uint32_t begin = 0; begin <= n + 1; begin++)
+    {
+      for (uint32_t end = 0; end <= n + 2; end++)
+        {
+          double nc = 0;
+          std::complex<double> c = 0;
+          for (uint32_t i = begin; i < std::min (end, n); i++)
+            {
+              nc += std::abs (pdp.GetTap (i).GetAmp ());
+              c += pdp.GetTap (i).GetAmp ();
+            }
+          Time tBegin = Seconds (begin * res);
+          Time tEnd = Seconds (end * res);
+          NS_TEST_ASSERT_MSG_EQ_TOL (pdp.SumTapsNc (tBegin, tEnd), nc, 1e-9,
+                                     name << ": wrong SumTapsNc over [" << begin << ", " << end << ")");
+          NS_TEST_ASSERT_MSG_EQ_TOL (std::abs (pdp.SumTapsC (tBegin, tEnd) - c), 0, 1e-9,
+                                     name << ": wrong SumTapsC over [" << begin << ", " << end << ")");
+
+          // Here begin is the delay and end the duration, from the peak.
+          // The delay is truncated to whole taps, keep it off the boundary.
+          Time tDelay = Seconds ((begin + 0.25) * res);
+          nc = 0;
+          c = 0;
+          for (uint32_t i = peak + begin; i < std::min (peak + begin + end, n); i++)
+            {
+              nc += std::abs (pdp.GetTap (i).GetAmp ());
+              c += pdp.GetTap (i).GetAmp ();
+            }
+          NS_TEST_ASSERT_MSG_EQ_TOL (pdp.SumTapsFromMaxNc (tDelay, tEnd), nc, 1e-9,
+                                     name << ": wrong SumTapsFromMaxNc at " << begin << " for " << end);
+          NS_TEST_ASSERT_MSG_EQ_TOL (std::abs (pdp.SumTapsFromMaxC (tDelay, tEnd) - c), 0, 1e-9,
+                                     name << ": wrong SumTapsFromMaxC at " << begin << " for " << end);
+        }
+    }
+}
+
+void
+LoraPdpSumsTest::DoRun (void)
+{
+  std::minstd_rand rng (1);
+  std::uniform_real_distribution<double> amp (-1.0, 1.0);
+  std::vector<std::complex<double> > amps;
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      amps.push_back (std::complex<double> (amp (rng), amp (rng)));
+    }
+  LoraPdp pdp (amps, MilliSeconds (1));
+  Check (pdp, "Random");
+
+  // A copy changed after its sums were used has the sums of its new taps.
+  LoraPdp copy = pdp;
+  copy.SetTap (std::complex<double> (3.0, -4.0), 7);
+  NS_TEST_ASSERT_MSG_EQ (copy.GetPeakTapIndex (), 7, "Peak not moved by SetTap");
+  Check (copy, "SetTap");
+  Check (pdp, "Original after SetTap");
+
+  copy.SetNTaps (50);
+  Check (copy, "SetNTaps");
+  copy.SetNTaps (5);
+  Check (copy, "Truncated");
+  copy.SetResolution (MicroSeconds (250));
+  Check (copy, "SetResolution");
+
+  LoraPdp ties (std::vector<double> (6, 0.5), MilliSeconds (1));
+  NS_TEST_ASSERT_MSG_EQ (ties.GetPeakTapIndex (), 0, "Peak is not the first of equal taps");
+  Check (ties, "Ties");
+
+  Check (LoraPdp (std::vector<double> (), MilliSeconds (1)), "Empty");
+}
+
+/**
+ * LoRa propagation model test suite.
+ */
+class LoraPropModelTestSuite : public TestSuite
+{
+public:
+  LoraPropModelTestSuite ();
+};
+
+LoraPropModelTestSuite::LoraPropModelTestSuite ()
+  : TestSuite ("lora-prop-model", UNIT)
+{
+  AddTestCase (new LoraPropModelBatchTest, TestCase::QUICK);
+  AddTestCase (new LoraPdpSharingTest, TestCase::QUICK);
+  AddTestCase (new LoraPdpSumsTest, TestCase::QUICK);
+}
+
+static LoraPropModelTestSuite g_loraPropModelTestSuite;
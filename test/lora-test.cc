@@ -20,6 +20,8 @@
 #include "ns3/lora-net-device.h"
 #include "ns3/lora-channel.h"
 #include "ns3/lora-phy-gen.h"
+#include "ns3/lora-phy-dual.h"
+#include "ns3/lora-region.h"
 #include "ns3/lora-transducer-hd.h"
 #include "ns3/lora-prop-model-ideal.h"
 #include "ns3/constant-position-mobility-model.h"
@@ -28,10 +30,19 @@
 #include "ns3/node.h"
 #include "ns3/object-factory.h"
 #include "ns3/pointer.h"
+#include "ns3/object-vector.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
 #include "ns3/callback.h"
 #include "ns3/nstime.h"
 #include "ns3/log.h"
 #include "ns3/mac-lora-gw.h"
+#include "ns3/lora-network-server.h"
+#include "ns3/lora-header-common.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 using namespace ns3;
 
@@ -323,6 +334,801 @@ LoraTestAca::DoRun (void)
 }
 
 
+class LoraTimeOnAirTest : public TestCase
+{
+public:
+  LoraTimeOnAirTest ();
+
+  virtual void DoRun (void);
+};
+
+LoraTimeOnAirTest::LoraTimeOnAirTest ()
+  : TestCase ("LoRa time on air")
+{
+}
+
+void
+LoraTimeOnAirTest::DoRun (void)
+{
+  // Reference values from the Semtech SX1272/76 datasheet formula.
+  LoraTxMode sf7 = LoraTxModeFactory::CreateLoraMode (7, 125000, 1, 868100000, 8, true, false, "ToaTestSf7");
+  NS_TEST_ASSERT_MSG_EQ (sf7.GetDataRateBps (), 5469, "Wrong SF7 data rate");
+  NS_TEST_ASSERT_MSG_EQ (sf7.GetPhyRateSps (), 977, "Wrong SF7 symbol rate");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sf7.GetTimeOnAir (20).GetSeconds (), 0.056576, 1e-9, "Wrong SF7 time on air");
+  // Past the precomputed table.
+  NS_TEST_ASSERT_MSG_EQ_TOL (sf7.GetTimeOnAir (300).GetSeconds (), 0.466176, 1e-9, "Wrong SF7 time on air of a large payload");
+
+  LoraTxMode sf7ih = LoraTxModeFactory::CreateLoraMode (7, 125000, 1, 868100000, 8, false, false, "ToaTestSf7Implicit");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sf7ih.GetTimeOnAir (20).GetSeconds (), 0.051456, 1e-9, "Wrong SF7 implicit header time on air");
+
+  LoraTxMode sf12 = LoraTxModeFactory::CreateLoraMode (12, 125000, 1, 868100000, 8, true, true, "ToaTestSf12");
+  NS_TEST_ASSERT_MSG_EQ (sf12.GetDataRateBps (), 293, "Wrong SF12 data rate");
+  NS_TEST_ASSERT_MSG_EQ (sf12.GetPhyRateSps (), 31, "Wrong SF12 symbol rate");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sf12.GetTimeOnAir (20).GetSeconds (), 1.318912, 1e-9, "Wrong SF12 time on air");
+}
+
+
+class LoraTxModeTableTest : public TestCase
+{
+public:
+  LoraTxModeTableTest ();
+
+  virtual void DoRun (void);
+};
+
+LoraTxModeTableTest::LoraTxModeTableTest ()
+  : TestCase ("LoRa mode table")
+{
+}
+
+void
+LoraTxModeTableTest::DoRun (void)
+{
+  LoraTxMode first = LoraTxModeFactory::CreateLoraMode (9, 125000, 1, 868300000, 8, true, false, "ModeTableTestFirst");
+  Time toa = first.GetTimeOnAir (20);
+
+  // Grow the table well past any initial capacity.
+  std::vector<LoraTxMode> modes;
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      std::ostringstream name;
+      name << "ModeTableTest" << i;
+      modes.push_back (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 100 + i, 50, 868000000 + i, 125, 2, name.str ()));
+    }
+  NS_TEST_ASSERT_MSG_EQ (first.GetName (), "ModeTableTestFirst", "Wrong name after the table grew");
+  NS_TEST_ASSERT_MSG_EQ (first.GetSpreadingFactor (), 9, "Wrong SF after the table grew");
+  NS_TEST_ASSERT_MSG_EQ (first.GetTimeOnAir (20), toa, "Wrong time on air after the table grew");
+  for (uint32_t i = 0; i < modes.size (); i++)
+    {
+      std::ostringstream name;
+      name << "ModeTableTest" << i;
+      NS_TEST_ASSERT_MSG_EQ (LoraTxModeFactory::GetMode (name.str ()).GetUid (), modes[i].GetUid (), "Wrong uid of " << name.str ());
+      NS_TEST_ASSERT_MSG_EQ (modes[i].GetDataRateBps (), 100 + i, "Wrong data rate of " << name.str ());
+      NS_TEST_ASSERT_MSG_EQ (modes[i].GetCenterFreqHz (), 868000000 + i, "Wrong frequency of " << name.str ());
+    }
+
+  // Redefining a mode by name updates it in place, for every copy.
+  LoraTxMode redefined = LoraTxModeFactory::CreateLoraMode (10, 125000, 1, 868500000, 8, true, false, "ModeTableTestFirst");
+  NS_TEST_ASSERT_MSG_EQ (redefined.GetUid (), first.GetUid (), "Redefined mode got a new uid");
+  NS_TEST_ASSERT_MSG_EQ (first.GetSpreadingFactor (), 10, "Redefinition not seen by an existing copy");
+  NS_TEST_ASSERT_MSG_EQ (first.GetCenterFreqHz (), 868500000, "Redefinition not seen by an existing copy");
+  NS_TEST_ASSERT_MSG_NE (first.GetTimeOnAir (20), toa, "Time on air not recomputed on redefinition");
+}
+
+
+class LoraPhyPerTableTest : public TestCase
+{
+public:
+  LoraPhyPerTableTest ();
+
+  virtual void DoRun (void);
+};
+
+LoraPhyPerTableTest::LoraPhyPerTableTest ()
+  : TestCase ("LoRa PER tables")
+{
+}
+
+void
+LoraPhyPerTableTest::DoRun (void)
+{
+  LoraPhyPerTable::Table table;
+  table.m_sinrStartDb = 0;
+  table.m_sinrStepDb = 1;
+  table.m_nSinr = 2;
+  table.m_sizes.push_back (10);
+  table.m_sizes.push_back (30);
+  table.m_per.push_back (0.0);
+  table.m_per.push_back (0.2);
+  table.m_per.push_back (0.4);
+  table.m_per.push_back (1.0);
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (table.Lookup (0, 10), 0.0, 1e-12, "Wrong PER on a grid point");
+  NS_TEST_ASSERT_MSG_EQ_TOL (table.Lookup (1, 30), 1.0, 1e-12, "Wrong PER on a grid point");
+  NS_TEST_ASSERT_MSG_EQ_TOL (table.Lookup (0.5, 20), 0.4, 1e-12, "Wrong bilinear interpolation");
+  NS_TEST_ASSERT_MSG_EQ_TOL (table.Lookup (0.25, 30), 0.4, 1e-12, "Wrong interpolation along the SINR");
+  NS_TEST_ASSERT_MSG_EQ_TOL (table.Lookup (-5, 5), 0.0, 1e-12, "PER not clamped below the table");
+  NS_TEST_ASSERT_MSG_EQ_TOL (table.Lookup (10, 100), 1.0, 1e-12, "PER not clamped above the table");
+
+  // The same table, from a file.
+  std::string fileName = CreateTempDirFilename ("lora-per-table.txt");
+  std::ofstream file (fileName.c_str ());
+  file << "# mode sinrStart sinrStep nSinr sizes..." << std::endl
+       << "table PerTableTestMode 0 1 2 10 30" << std::endl
+       << "0.0 0.2" << std::endl
+       << "0.4 1.0" << std::endl;
+  file.close ();
+
+  LoraTxMode tableMode = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10000, 125, 2, "PerTableTestMode");
+  LoraTxMode otherMode = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10000, 125, 2, "PerTableTestOther");
+  LoraTxMode sf7 = LoraTxModeFactory::CreateLoraMode (7, 125000, 1, 868100000, 8, true, false, "PerTableTestSf7");
+
+  Ptr<LoraPhyPerTable> per = CreateObject<LoraPhyPerTable> ();
+  per->SetAttribute ("TableFile", StringValue (fileName));
+  Ptr<Packet> pkt = Create<Packet> (20);
+  NS_TEST_ASSERT_MSG_EQ_TOL (per->CalcPer (pkt, 0.5, tableMode), 0.4, 1e-12, "Wrong PER from the file table");
+
+  // No table: threshold model.
+  NS_TEST_ASSERT_MSG_EQ (per->CalcPer (pkt, 7.9, otherMode), 1, "Wrong PER below the threshold");
+  NS_TEST_ASSERT_MSG_EQ (per->CalcPer (pkt, 8, otherMode), 0, "Wrong PER at the threshold");
+
+  // Built-in LoRa table.
+  NS_TEST_ASSERT_MSG_GT (per->CalcPer (pkt, -30, sf7), 0.99, "SF7 decoded far below its sensitivity");
+  NS_TEST_ASSERT_MSG_LT (per->CalcPer (pkt, 10, sf7), 1e-6, "SF7 lost far above its sensitivity");
+  NS_TEST_ASSERT_MSG_LT (per->CalcPer (pkt, -5, sf7), per->CalcPer (pkt, -10, sf7), "SF7 PER not decreasing with the SINR");
+}
+
+
+class LoraRegionTest : public TestCase
+{
+public:
+  LoraRegionTest ();
+
+  virtual void DoRun (void);
+};
+
+LoraRegionTest::LoraRegionTest ()
+  : TestCase ("LoRa regional channel plans")
+{
+}
+
+void
+LoraRegionTest::DoRun (void)
+{
+  // RP002-1.0.x EU868 data rates and maximum MAC payload sizes (M).
+  const uint32_t sf[] = { 12, 11, 10, 9, 8, 7, 7 };
+  const uint32_t bwHz[] = { 125000, 125000, 125000, 125000, 125000, 125000, 250000 };
+  const uint32_t maxPayload[] = { 59, 59, 59, 123, 230, 230, 230 };
+
+  const LoraRegion::Plan &plan = LoraRegion::GetPlan (LoraRegion::EU868);
+  NS_TEST_ASSERT_MSG_EQ (plan.m_nDataRates, 7, "Wrong number of data rates");
+  for (uint32_t dr = 0; dr < plan.m_nDataRates; dr++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (plan.m_dataRates[dr].m_sf, sf[dr], "Wrong SF of DR" << dr);
+      NS_TEST_ASSERT_MSG_EQ (plan.m_dataRates[dr].m_bwHz, bwHz[dr], "Wrong bandwidth of DR" << dr);
+      NS_TEST_ASSERT_MSG_EQ (plan.m_dataRates[dr].m_maxPayload, maxPayload[dr], "Wrong maximum payload of DR" << dr);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (plan.m_nChannels, 3, "Wrong number of default channels");
+  LoraTxMode mode = LoraRegion::GetMode (LoraRegion::EU868, 2, 5);
+  NS_TEST_ASSERT_MSG_EQ (mode.GetCenterFreqHz (), 868500000, "Wrong channel frequency");
+  NS_TEST_ASSERT_MSG_EQ (mode.GetSpreadingFactor (), 7, "Wrong DR5 spreading factor");
+  NS_TEST_ASSERT_MSG_EQ (LoraRegion::GetModes (LoraRegion::EU868, 0).GetNModes (), 3, "Wrong number of DR0 modes");
+
+  LoraTxMode rx2 = LoraRegion::GetRx2Mode (LoraRegion::EU868);
+  NS_TEST_ASSERT_MSG_EQ (rx2.GetCenterFreqHz (), 869525000, "Wrong RX2 frequency");
+  NS_TEST_ASSERT_MSG_EQ (rx2.GetSpreadingFactor (), 12, "Wrong RX2 spreading factor");
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (LoraRegion::GetSubBand (LoraRegion::EU868, 868100000)->m_dutyCycle, 0.01, 1e-12, "Wrong duty cycle of sub-band g1");
+  NS_TEST_ASSERT_MSG_EQ_TOL (LoraRegion::GetSubBand (LoraRegion::EU868, 869525000)->m_dutyCycle, 0.1, 1e-12, "Wrong duty cycle of sub-band g3");
+  NS_TEST_ASSERT_MSG_EQ (LoraRegion::GetSubBand (LoraRegion::EU868, 868650000), 0, "Frequency between sub-bands");
+  // Sub-bands exclude their upper edge: a shared edge is in the upper one.
+  NS_TEST_ASSERT_MSG_EQ (LoraRegion::GetSubBand (LoraRegion::EU868, 868000000)->m_minHz, 868000000, "Shared edge not in the upper sub-band");
+  NS_TEST_ASSERT_MSG_EQ (LoraRegion::GetSubBand (LoraRegion::EU868, 867999999)->m_maxHz, 868000000, "Wrong sub-band below a shared edge");
+  NS_TEST_ASSERT_MSG_EQ (LoraRegion::GetSubBand (LoraRegion::EU868, 869650000), 0, "Upper edge of sub-band g3 included");
+  NS_TEST_ASSERT_MSG_EQ (LoraRegion::GetSubBand (LoraRegion::EU868, 870000000), 0, "Upper edge of the band included");
+
+  // US915: 64 + 8 uplink channels, then 8 downlink channels.
+  const LoraRegion::Plan &us = LoraRegion::GetPlan (LoraRegion::US915);
+  NS_TEST_ASSERT_MSG_EQ (us.m_nChannels, 80, "Wrong number of US915 channels");
+  NS_TEST_ASSERT_MSG_EQ (us.m_nDataRates, 14, "Wrong number of US915 data rates");
+  LoraTxMode up125 = LoraRegion::GetMode (LoraRegion::US915, 63, 0);
+  NS_TEST_ASSERT_MSG_EQ (up125.GetCenterFreqHz (), 914900000, "Wrong frequency of US915 channel 63");
+  NS_TEST_ASSERT_MSG_EQ (up125.GetSpreadingFactor (), 10, "Wrong US915 DR0 spreading factor");
+  NS_TEST_ASSERT_MSG_EQ (up125.GetBandwidthHz (), 125000, "Wrong US915 DR0 bandwidth");
+  for (uint32_t c = 64; c < 72; c++)
+    {
+      LoraTxMode up500 = LoraRegion::GetMode (LoraRegion::US915, c, 4);
+      NS_TEST_ASSERT_MSG_EQ (up500.GetCenterFreqHz (), 903000000 + (c - 64) * 1600000, "Wrong frequency of US915 channel " << c);
+      NS_TEST_ASSERT_MSG_EQ (up500.GetSpreadingFactor (), 8, "Wrong DR4 spreading factor on channel " << c);
+      NS_TEST_ASSERT_MSG_EQ (up500.GetBandwidthHz (), 500000, "Wrong DR4 bandwidth on channel " << c);
+    }
+  NS_TEST_ASSERT_MSG_EQ (LoraRegion::GetModes (LoraRegion::US915, 4).GetNModes (), 8, "Wrong number of US915 DR4 modes");
+  NS_TEST_ASSERT_MSG_EQ (LoraRegion::GetModes (LoraRegion::US915, 0).GetNModes (), 64, "Wrong number of US915 DR0 modes");
+  NS_TEST_ASSERT_MSG_EQ (LoraRegion::GetModes (LoraRegion::US915, 5).GetNModes (), 0, "Modes on the undefined US915 DR5");
+  const uint32_t downSf[] = { 12, 11, 10, 9, 8, 7 };
+  for (uint32_t c = 72; c < 80; c++)
+    {
+      for (uint32_t dr = 8; dr <= 13; dr++)
+        {
+          LoraTxMode down = LoraRegion::GetMode (LoraRegion::US915, c, dr);
+          NS_TEST_ASSERT_MSG_EQ (down.GetCenterFreqHz (), 923300000 + (c - 72) * 600000, "Wrong frequency of US915 channel " << c);
+          NS_TEST_ASSERT_MSG_EQ (down.GetSpreadingFactor (), downSf[dr - 8], "Wrong DR" << dr << " spreading factor");
+          NS_TEST_ASSERT_MSG_EQ (down.GetBandwidthHz (), 500000, "Wrong DR" << dr << " bandwidth");
+        }
+    }
+  LoraTxMode usRx2 = LoraRegion::GetRx2Mode (LoraRegion::US915);
+  NS_TEST_ASSERT_MSG_EQ (usRx2.GetCenterFreqHz (), 923300000, "Wrong US915 RX2 frequency");
+  NS_TEST_ASSERT_MSG_EQ (usRx2.GetSpreadingFactor (), 12, "Wrong US915 RX2 spreading factor");
+  NS_TEST_ASSERT_MSG_EQ (usRx2.GetBandwidthHz (), 500000, "Wrong US915 RX2 bandwidth");
+  NS_TEST_ASSERT_MSG_EQ (usRx2.GetUid (), LoraRegion::GetMode (LoraRegion::US915, 72, 8).GetUid (), "US915 RX2 is not downlink channel 0 at DR8");
+}
+
+
+class LoraPhyGenModesTest : public TestCase
+{
+public:
+  LoraPhyGenModesTest ();
+
+  virtual void DoRun (void);
+private:
+  /** Count a SupportedModes change. */
+  void ModesChanged (void);
+
+  uint32_t m_changes;
+};
+
+LoraPhyGenModesTest::LoraPhyGenModesTest ()
+  : TestCase ("LoRa PHY supported mode bitmap"),
+    m_changes (0)
+{
+}
+
+void
+LoraPhyGenModesTest::ModesChanged (void)
+{
+  m_changes++;
+}
+
+void
+LoraPhyGenModesTest::DoRun (void)
+{
+  Ptr<LoraPhyGen> phy = CreateObject<LoraPhyGen> ();
+  LoraModesList defaults = LoraPhyGen::GetDefaultModes ();
+  for (uint32_t i = 0; i < defaults.GetNModes (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (phy->SupportsMode (defaults[i]), true, "Default mode " << i << " not supported");
+    }
+
+  std::vector<LoraTxMode> modes;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      std::ostringstream name;
+      name << "BitmapTestMode" << i;
+      modes.push_back (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10000 + 1000 * i, 125, 2, name.str ()));
+    }
+  phy->SetModesChangedCallback (MakeCallback (&LoraPhyGenModesTest::ModesChanged, this));
+
+  LoraModesList high;
+  high.AppendMode (modes[1]);
+  high.AppendMode (modes[3]);
+  phy->SetAttribute ("SupportedModes", LoraModesListValue (high));
+  NS_TEST_ASSERT_MSG_EQ (m_changes, 1, "Mode change not notified");
+  NS_TEST_ASSERT_MSG_EQ (phy->GetNModes (), 2, "Wrong number of modes");
+  for (uint32_t i = 0; i < defaults.GetNModes (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (phy->SupportsMode (defaults[i]), false, "Replaced mode " << i << " still supported");
+    }
+  for (uint32_t i = 0; i < modes.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (phy->SupportsMode (modes[i]), i % 2 == 1, "Wrong support of mode " << i);
+    }
+
+  // Lower uids only: the bitmap shrinks and drops the higher ones.
+  LoraModesList low;
+  low.AppendMode (modes[0]);
+  phy->SetAttribute ("SupportedModes", LoraModesListValue (low));
+  NS_TEST_ASSERT_MSG_EQ (m_changes, 2, "Mode change not notified");
+  for (uint32_t i = 0; i < modes.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (phy->SupportsMode (modes[i]), i == 0, "Wrong support of mode " << i);
+    }
+
+  // A mode created after the bitmap was built is past its end.
+  LoraTxMode later = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 20000, 125, 2, "BitmapTestLater");
+  NS_TEST_ASSERT_MSG_EQ (phy->SupportsMode (later), false, "Mode past the bitmap supported");
+  low.AppendMode (later);
+  phy->SetAttribute ("SupportedModes", LoraModesListValue (low));
+  NS_TEST_ASSERT_MSG_EQ (phy->SupportsMode (later), true, "Added mode not supported");
+  NS_TEST_ASSERT_MSG_EQ (phy->GetMode (1).GetUid (), later.GetUid (), "Mode numbers not in list order");
+
+  phy->SetAttribute ("SupportedModes", LoraModesListValue (LoraModesList ()));
+  NS_TEST_ASSERT_MSG_EQ (phy->GetNModes (), 0, "Modes left in an empty list");
+  NS_TEST_ASSERT_MSG_EQ (phy->SupportsMode (modes[0]), false, "Mode supported with an empty list");
+  NS_TEST_ASSERT_MSG_EQ (m_changes, 4, "Mode changes not all notified");
+  phy->Dispose ();
+}
+
+class LoraPhyDualModesTest : public TestCase
+{
+public:
+  LoraPhyDualModesTest ();
+
+  virtual void DoRun (void);
+private:
+  void SendOnePacket (Ptr<LoraNetDevice> dev, uint32_t mode);
+  void TxPhy (Ptr<const Packet> pkt, double txPowerDb, LoraTxMode mode);
+  void CheckTx (Ptr<LoraPhyDual> phy, uint32_t i);
+  void CheckNumbered (Ptr<LoraPhyDual> phy);
+
+  uint32_t m_txUid;
+};
+
+LoraPhyDualModesTest::LoraPhyDualModesTest ()
+  : TestCase ("LoRa dual PHY mode routing"),
+    m_txUid (0)
+{
+}
+
+void
+LoraPhyDualModesTest::SendOnePacket (Ptr<LoraNetDevice> dev, uint32_t mode)
+{
+  Ptr<Packet> pkt = Create<Packet> (13);
+  dev->Send (pkt, dev->GetBroadcast (), mode);
+}
+
+void
+LoraPhyDualModesTest::TxPhy (Ptr<const Packet> pkt, double txPowerDb, LoraTxMode mode)
+{
+  m_txUid = mode.GetUid ();
+}
+
+void
+LoraPhyDualModesTest::CheckTx (Ptr<LoraPhyDual> phy, uint32_t i)
+{
+  for (uint32_t j = 0; j < phy->GetNPhys (); j++)
+    {
+      if (phy->GetPhy (j))
+        {
+          NS_TEST_EXPECT_MSG_EQ (phy->IsPhyTx (j), i == j, "Wrong transmitting sub-PHY " << j);
+        }
+    }
+}
+
+// The numbered queries are deprecated, but must keep forwarding.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+void
+LoraPhyDualModesTest::CheckNumbered (Ptr<LoraPhyDual> phy)
+{
+  bool idle[] = { phy->IsPhy1Idle (), phy->IsPhy2Idle (), phy->IsPhy3Idle (), phy->IsPhy4Idle () };
+  bool rx[] = { phy->IsPhy1Rx (), phy->IsPhy2Rx (), phy->IsPhy3Rx (), phy->IsPhy4Rx () };
+  bool tx[] = { phy->IsPhy1Tx (), phy->IsPhy2Tx (), phy->IsPhy3Tx (), phy->IsPhy4Tx () };
+  Ptr<Packet> pkt[] = { phy->GetPhy1PacketRx (), phy->GetPhy2PacketRx (), phy->GetPhy3PacketRx (), phy->GetPhy4PacketRx () };
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (idle[i], phy->IsPhyIdle (i), "IsPhy" << i + 1 << "Idle is not IsPhyIdle (" << i << ")");
+      NS_TEST_EXPECT_MSG_EQ (rx[i], phy->IsPhyRx (i), "IsPhy" << i + 1 << "Rx is not IsPhyRx (" << i << ")");
+      NS_TEST_EXPECT_MSG_EQ (tx[i], phy->IsPhyTx (i), "IsPhy" << i + 1 << "Tx is not IsPhyTx (" << i << ")");
+      NS_TEST_EXPECT_MSG_EQ (pkt[i], phy->GetPhyPacketRx (i), "GetPhy" << i + 1 << "PacketRx is not GetPhyPacketRx (" << i << ")");
+    }
+  NS_TEST_EXPECT_MSG_EQ (phy->IsPhy18Idle (), phy->IsPhyIdle (17), "IsPhy18Idle is not IsPhyIdle (17)");
+}
+#pragma GCC diagnostic pop
+
+void
+LoraPhyDualModesTest::DoRun (void)
+{
+  std::vector<LoraTxMode> modes;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      std::ostringstream name;
+      name << "RouteTestMode" << i;
+      modes.push_back (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10000 + 1000 * i, 125, 2, name.str ()));
+    }
+  LoraModesList m0;
+  m0.AppendMode (modes[0]);
+  m0.AppendMode (modes[1]);
+  LoraModesList m1;
+  m1.AppendMode (modes[2]);
+  LoraModesList m2;
+  m2.AppendMode (modes[3]);
+  m2.AppendMode (modes[4]);
+  m2.AppendMode (modes[5]);
+
+  // Sub-PHY 1 is left empty, so not instantiated.
+  Ptr<LoraPhyDual> phy = CreateObject<LoraPhyDual> ();
+  phy->SetAttribute ("SupportedModesPhy1", LoraModesListValue (m0));
+  phy->SetAttribute ("SupportedModesPhy3", LoraModesListValue (m2));
+
+  NS_TEST_ASSERT_MSG_EQ (phy->GetNModes (), 5, "Wrong number of modes");
+  uint32_t before[] = { 0, 1, 3, 4, 5 };
+  for (uint32_t k = 0; k < 5; k++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (phy->GetMode (k).GetUid (), modes[before[k]].GetUid (), "Wrong mode " << k);
+    }
+
+  // Filling sub-PHY 1 shifts the modes of sub-PHY 2.
+  phy->SetModesPhy (1, m1);
+  NS_TEST_ASSERT_MSG_EQ (phy->GetNModes (), 6, "Wrong number of modes after a change");
+  for (uint32_t k = 0; k < 6; k++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (phy->GetMode (k).GetUid (), modes[k].GetUid (), "Wrong mode " << k << " after a change");
+    }
+
+  Ptr<LoraChannel> channel = CreateObject<LoraChannel> ();
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<LoraNetDevice> dev = CreateObject<LoraNetDevice> ();
+  Ptr<MacLoraAca> mac = CreateObject<MacLoraAca> ();
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  node->AggregateObject (mobility);
+  mac->SetAddress (LoraAddress::Allocate ());
+  dev->SetPhy (phy);
+  dev->SetMac (mac);
+  dev->SetChannel (channel);
+  dev->SetTransducer (CreateObject<LoraTransducerHd> ());
+  node->AddDevice (dev);
+
+  // Mode 4 is the second mode of sub-PHY 2.
+  phy->GetPhy (2)->TraceConnectWithoutContext ("Tx", MakeCallback (&LoraPhyDualModesTest::TxPhy, this));
+  Simulator::Schedule (Seconds (1.0), &LoraPhyDualModesTest::SendOnePacket, this, dev, 4);
+  Simulator::Schedule (Seconds (1.1), &LoraPhyDualModesTest::CheckTx, this, phy, 2);
+  Simulator::Schedule (Seconds (1.1), &LoraPhyDualModesTest::CheckNumbered, this, phy);
+  CheckNumbered (phy);
+
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_txUid, modes[4].GetUid (), "Wrong mode transmitted by sub-PHY 2");
+}
+
+
+class LoraPhyDualDefaultsTest : public TestCase
+{
+public:
+  LoraPhyDualDefaultsTest ();
+
+  virtual void DoRun (void);
+};
+
+LoraPhyDualDefaultsTest::LoraPhyDualDefaultsTest ()
+  : TestCase ("LoRa dual PHY default sub-PHYs")
+{
+}
+
+void
+LoraPhyDualDefaultsTest::DoRun (void)
+{
+  LoraModesList defaults = LoraPhyGen::GetDefaultModes ();
+  uint32_t n = defaults.GetNModes ();
+
+  // Only Phy1 gets the default modes, the other slots stay empty.
+  Ptr<LoraPhyDual> phy = CreateObject<LoraPhyDual> ();
+  NS_TEST_ASSERT_MSG_EQ (phy->GetNPhys (), LoraPhyDual::NUMBERED_PHYS, "Wrong default number of sub-PHYs");
+  NS_TEST_ASSERT_MSG_NE (phy->GetPhy (0), 0, "Phy1 not instantiated");
+  for (uint32_t i = 1; i < phy->GetNPhys (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (phy->GetPhy (i), 0, "Unconfigured sub-PHY " << i << " instantiated");
+      NS_TEST_ASSERT_MSG_EQ (phy->GetModesPhy (i).GetNModes (), 0, "Modes on unconfigured sub-PHY " << i);
+      NS_TEST_ASSERT_MSG_EQ (phy->IsPhyIdle (i), true, "Unconfigured sub-PHY " << i << " not idle");
+    }
+  NS_TEST_ASSERT_MSG_EQ (phy->GetNModes (), n, "Wrong default number of modes");
+  for (uint32_t k = 0; k < n; k++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (phy->GetMode (k).GetUid (), defaults[k].GetUid (), "Wrong default mode " << k);
+    }
+  ObjectVectorValue subPhys;
+  phy->GetAttribute ("SubPhys", subPhys);
+  NS_TEST_ASSERT_MSG_EQ (subPhys.GetN (), 1, "Wrong number of listed sub-PHYs");
+
+  // The previous layout, with the default modes on every sub-PHY.
+  std::ostringstream phyModes;
+  for (uint32_t i = 0; i < phy->GetNPhys (); i++)
+    {
+      phyModes << (i > 0 ? ";" : "") << defaults;
+    }
+  phy->SetAttribute ("PhyModes", StringValue (phyModes.str ()));
+  NS_TEST_ASSERT_MSG_EQ (phy->GetNModes (), LoraPhyDual::NUMBERED_PHYS * n, "Wrong number of modes of the previous layout");
+  phy->GetAttribute ("SubPhys", subPhys);
+  NS_TEST_ASSERT_MSG_EQ (subPhys.GetN (), LoraPhyDual::NUMBERED_PHYS, "Wrong number of sub-PHYs of the previous layout");
+  for (uint32_t k = 0; k < phy->GetNModes (); k++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (phy->GetMode (k).GetUid (), defaults[k % n].GetUid (), "Wrong mode " << k << " of the previous layout");
+    }
+
+  // The default PER and SINR models are shared by the sub-PHYs of one
+  // PHY, not across PHYs.
+  PointerValue per0, per1, sinr0, sinr1;
+  phy->GetPhy (0)->GetAttribute ("PerModel", per0);
+  phy->GetPhy (1)->GetAttribute ("PerModel", per1);
+  phy->GetPhy (0)->GetAttribute ("SinrModel", sinr0);
+  phy->GetPhy (1)->GetAttribute ("SinrModel", sinr1);
+  NS_TEST_ASSERT_MSG_EQ (per0.Get<LoraPhyPer> (), per1.Get<LoraPhyPer> (), "Default PER model not shared by sub-PHYs");
+  NS_TEST_ASSERT_MSG_EQ (sinr0.Get<LoraPhyCalcSinr> (), sinr1.Get<LoraPhyCalcSinr> (), "Default SINR model not shared by sub-PHYs");
+  Ptr<LoraPhyDual> other = CreateObject<LoraPhyDual> ();
+  PointerValue otherPer;
+  other->GetPhy (0)->GetAttribute ("PerModel", otherPer);
+  NS_TEST_ASSERT_MSG_NE (otherPer.Get<LoraPhyPer> (), per0.Get<LoraPhyPer> (), "Default PER model shared by two PHYs");
+
+  phy->Dispose ();
+  other->Dispose ();
+}
+
+class LoraDemodulatorTest : public TestCase
+{
+public:
+  LoraDemodulatorTest ();
+
+  virtual void DoRun (void);
+private:
+  Ptr<LoraNetDevice> CreateDevice (Vector pos, Ptr<LoraChannel> chan);
+  bool RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
+  void SendOnePacket (Ptr<LoraNetDevice> dev, uint32_t mode);
+  void InUseChanged (uint32_t oldValue, uint32_t newValue);
+  void DropsChanged (uint32_t oldValue, uint32_t newValue);
+  void CheckReleased (std::string path);
+
+  ObjectFactory m_phyFac;
+  uint32_t m_bytesRx;
+  uint32_t m_inUse;
+  uint32_t m_maxInUse;
+  uint32_t m_drops;
+};
+
+LoraDemodulatorTest::LoraDemodulatorTest ()
+  : TestCase ("LoRa gateway demodulator pool"),
+    m_bytesRx (0),
+    m_inUse (0),
+    m_maxInUse (0),
+    m_drops (0)
+{
+}
+
+Ptr<LoraNetDevice>
+LoraDemodulatorTest::CreateDevice (Vector pos, Ptr<LoraChannel> chan)
+{
+  Ptr<LoraPhy> phy = m_phyFac.Create<LoraPhy> ();
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<LoraNetDevice> dev = CreateObject<LoraNetDevice> ();
+  Ptr<MacLoraAca> mac = CreateObject<MacLoraAca> ();
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<LoraTransducerHd> trans = CreateObject<LoraTransducerHd> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (LoraAddress::Allocate ());
+
+  dev->SetPhy (phy);
+  dev->SetMac (mac);
+  dev->SetChannel (chan);
+  dev->SetTransducer (trans);
+  node->AddDevice (dev);
+
+  return dev;
+}
+
+bool
+LoraDemodulatorTest::RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender)
+{
+  m_bytesRx += pkt->GetSize ();
+  return true;
+}
+
+void
+LoraDemodulatorTest::SendOnePacket (Ptr<LoraNetDevice> dev, uint32_t mode)
+{
+  Ptr<Packet> pkt = Create<Packet> (13);
+  dev->Send (pkt, dev->GetBroadcast (), mode);
+}
+
+void
+LoraDemodulatorTest::InUseChanged (uint32_t oldValue, uint32_t newValue)
+{
+  m_inUse = newValue;
+  m_maxInUse = std::max (m_maxInUse, newValue);
+}
+
+void
+LoraDemodulatorTest::DropsChanged (uint32_t oldValue, uint32_t newValue)
+{
+  m_drops = newValue;
+}
+
+void
+LoraDemodulatorTest::CheckReleased (std::string path)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_inUse, 0, "Demodulator not released on " << path);
+}
+
+void
+LoraDemodulatorTest::DoRun (void)
+{
+  LoraModesList m0;
+  m0.AppendMode (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10000, 125, 2, "DemodTestMode0"));
+  LoraModesList m1;
+  m1.AppendMode (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 11000, 125, 2, "DemodTestMode1"));
+  LoraModesList m2;
+  m2.AppendMode (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 12000, 125, 2, "DemodTestMode2"));
+
+  m_phyFac.SetTypeId ("ns3::LoraPhyDual");
+  m_phyFac.Set ("SupportedModesPhy1", LoraModesListValue (m0));
+  m_phyFac.Set ("SupportedModesPhy2", LoraModesListValue (m1));
+  m_phyFac.Set ("SupportedModesPhy3", LoraModesListValue (m2));
+
+  Ptr<LoraChannel> channel = CreateObject<LoraChannel> ();
+  channel->SetAttribute ("PropagationModel", PointerValue (CreateObject<LoraPropModelIdeal> ()));
+
+  Ptr<LoraNetDevice> gw = CreateDevice (Vector (50, 50, 50), channel);
+  Ptr<LoraNetDevice> dev[3];
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      dev[i] = CreateDevice (Vector (100 + 50 * i, 50, 50), channel);
+    }
+
+  Ptr<LoraPhyDual> phy = DynamicCast<LoraPhyDual> (gw->GetPhy ());
+  phy->SetAttribute ("Demodulators", UintegerValue (2));
+  phy->TraceConnectWithoutContext ("DemodulatorsInUse", MakeCallback (&LoraDemodulatorTest::InUseChanged, this));
+  phy->TraceConnectWithoutContext ("DemodulatorDrops", MakeCallback (&LoraDemodulatorTest::DropsChanged, this));
+  gw->SetReceiveCallback (MakeCallback (&LoraDemodulatorTest::RxPacket, this));
+
+  // Three overlapping preambles on three sub-PHYs: the third one is dropped.
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Simulator::Schedule (Seconds (1.0), &LoraDemodulatorTest::SendOnePacket, this, dev[i], i);
+    }
+  Simulator::Schedule (Seconds (2.0), &LoraDemodulatorTest::CheckReleased, this, "reception end");
+
+  // The gateway transmits during two receptions: the one on the same
+  // sub-PHY is aborted, the other one fails at its end.
+  Simulator::Schedule (Seconds (3.0), &LoraDemodulatorTest::SendOnePacket, this, dev[0], 0);
+  Simulator::Schedule (Seconds (3.0), &LoraDemodulatorTest::SendOnePacket, this, dev[1], 1);
+  Simulator::Schedule (Seconds (3.1), &LoraDemodulatorTest::SendOnePacket, this, gw, 0);
+  Simulator::Schedule (Seconds (4.0), &LoraDemodulatorTest::CheckReleased, this, "transmission");
+
+  // The sub-PHY sleeps until after the end of the reception.
+  Simulator::Schedule (Seconds (5.0), &LoraDemodulatorTest::SendOnePacket, this, dev[0], 0);
+  Simulator::Schedule (Seconds (5.1), &LoraPhyGen::SetSleepMode, phy->GetPhy (0), true);
+  Simulator::Schedule (Seconds (5.6), &LoraPhyGen::SetSleepMode, phy->GetPhy (0), false);
+  Simulator::Schedule (Seconds (6.0), &LoraDemodulatorTest::CheckReleased, this, "sleep");
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_maxInUse, 2, "More demodulators in use than configured");
+  NS_TEST_ASSERT_MSG_EQ (m_drops, 1, "Wrong number of preambles dropped");
+  NS_TEST_ASSERT_MSG_EQ (m_inUse, 0, "Demodulators still in use");
+  NS_TEST_ASSERT_MSG_EQ (m_bytesRx, 26, "Wrong number of bytes received");
+}
+
+
+class LoraNetworkServerTest : public TestCase
+{
+public:
+  LoraNetworkServerTest ();
+
+  virtual void DoRun (void);
+private:
+  Ptr<LoraNetDevice> CreateGateway (uint8_t addr);
+  void ReceiveCopy (uint8_t src, int32_t frameCounter, Ptr<LoraNetDevice> gw, double sinr);
+  void CheckDownlinkGateway (uint8_t src, Ptr<LoraNetDevice> gw);
+  void Delivered (Ptr<Packet> pkt, const LoraAddress &src);
+  void Duplicate (Ptr<const Packet> pkt, const LoraAddress &src, const LoraAddress &gateway, double sinr);
+
+  Ptr<LoraNetworkServer> m_ns;
+  uint32_t m_delivered;
+  uint32_t m_duplicates;
+};
+
+LoraNetworkServerTest::LoraNetworkServerTest ()
+  : TestCase ("LoRa network server deduplication"),
+    m_delivered (0),
+    m_duplicates (0)
+{
+}
+
+Ptr<LoraNetDevice>
+LoraNetworkServerTest::CreateGateway (uint8_t addr)
+{
+  Ptr<LoraNetDevice> dev = CreateObject<LoraNetDevice> ();
+  Ptr<MacLoraAca> mac = CreateObject<MacLoraAca> ();
+  mac->SetAddress (LoraAddress (addr));
+  dev->SetMac (mac);
+  return dev;
+}
+
+void
+LoraNetworkServerTest::ReceiveCopy (uint8_t src, int32_t frameCounter, Ptr<LoraNetDevice> gw, double sinr)
+{
+  Ptr<Packet> pkt = Create<Packet> (13);
+  if (frameCounter >= 0)
+    {
+      LoraFrameCounterTag tag (frameCounter);
+      pkt->AddPacketTag (tag);
+    }
+  m_ns->Receive (pkt, LoraAddress (src), sinr, LoraAddress::ConvertFrom (gw->GetAddress ()));
+}
+
+void
+LoraNetworkServerTest::CheckDownlinkGateway (uint8_t src, Ptr<LoraNetDevice> gw)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_ns->GetDownlinkGateway (LoraAddress (src)), gw,
+                         "Wrong downlink gateway at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+LoraNetworkServerTest::Delivered (Ptr<Packet> pkt, const LoraAddress &src)
+{
+  ++m_delivered;
+}
+
+void
+LoraNetworkServerTest::Duplicate (Ptr<const Packet> pkt, const LoraAddress &src, const LoraAddress &gateway, double sinr)
+{
+  ++m_duplicates;
+}
+
+void
+LoraNetworkServerTest::DoRun (void)
+{
+  m_ns = CreateObject<LoraNetworkServer> ();
+  m_ns->SetAttribute ("DedupWindow", TimeValue (MilliSeconds (200)));
+  m_ns->SetReceiveCallback (MakeCallback (&LoraNetworkServerTest::Delivered, this));
+  m_ns->TraceConnectWithoutContext ("Duplicate", MakeCallback (&LoraNetworkServerTest::Duplicate, this));
+
+  Ptr<LoraNetDevice> gwA = CreateGateway (1);
+  Ptr<LoraNetDevice> gwB = CreateGateway (2);
+  m_ns->AddGateway (gwA);
+  m_ns->AddGateway (gwB);
+
+  // Two copies, the second one better: B becomes the downlink gateway.
+  Simulator::Schedule (MilliSeconds (1000), &LoraNetworkServerTest::ReceiveCopy, this, 10, 5, gwA, 3.0);
+  Simulator::Schedule (MilliSeconds (1050), &LoraNetworkServerTest::ReceiveCopy, this, 10, 5, gwB, 8.0);
+  Simulator::Schedule (MilliSeconds (1100), &LoraNetworkServerTest::CheckDownlinkGateway, this, 10, gwB);
+  // Exactly one window after the first copy: a new uplink.
+  Simulator::Schedule (MilliSeconds (1200), &LoraNetworkServerTest::ReceiveCopy, this, 10, 5, gwA, 1.0);
+  Simulator::Schedule (MilliSeconds (1250), &LoraNetworkServerTest::CheckDownlinkGateway, this, 10, gwA);
+  // No frame counter: delivered without deduplication.
+  Simulator::Schedule (MilliSeconds (1300), &LoraNetworkServerTest::ReceiveCopy, this, 10, -1, gwA, 4.0);
+  // Just inside the window, with a worse SINR: A stays the best gateway.
+  Simulator::Schedule (MilliSeconds (2000), &LoraNetworkServerTest::ReceiveCopy, this, 11, 7, gwA, 5.0);
+  Simulator::Schedule (MilliSeconds (2199), &LoraNetworkServerTest::ReceiveCopy, this, 11, 7, gwB, 2.0);
+  Simulator::Schedule (MilliSeconds (2300), &LoraNetworkServerTest::CheckDownlinkGateway, this, 11, gwA);
+  // Frames sent by gateway B and overheard by A are not uplinks.
+  Simulator::Schedule (MilliSeconds (3000), &LoraNetworkServerTest::ReceiveCopy, this, 2, 9, gwA, 10.0);
+  Simulator::Schedule (MilliSeconds (3010), &LoraNetworkServerTest::ReceiveCopy, this, 2, -1, gwA, 10.0);
+  Simulator::Schedule (MilliSeconds (3100), &LoraNetworkServerTest::CheckDownlinkGateway, this, 2, Ptr<LoraNetDevice> ());
+
+  Simulator::Run ();
+  m_ns->Flush ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_delivered, 4, "Wrong number of delivered uplinks, or gateway frames delivered");
+  NS_TEST_ASSERT_MSG_EQ (m_duplicates, 2, "Wrong number of duplicates");
+
+  const std::vector<uint32_t> &histogram = m_ns->GetCopiesHistogram ();
+  NS_TEST_ASSERT_MSG_EQ (histogram.size (), 3, "Wrong histogram size");
+  NS_TEST_ASSERT_MSG_EQ (histogram[1], 1, "Wrong number of single copy uplinks");
+  NS_TEST_ASSERT_MSG_EQ (histogram[2], 2, "Wrong number of two copy uplinks");
+
+  const LoraNetworkServer::GatewayStats &a = m_ns->GetGatewayStats (0);
+  NS_TEST_ASSERT_MSG_EQ (a.m_received, 4, "Wrong copies received by gateway A, or gateway frames counted");
+  NS_TEST_ASSERT_MSG_EQ (a.m_first, 3, "Wrong first copies of gateway A");
+  NS_TEST_ASSERT_MSG_EQ (a.m_selected, 2, "Wrong selections of gateway A");
+  NS_TEST_ASSERT_MSG_EQ (a.m_unique, 1, "Wrong unique uplinks of gateway A");
+
+  const LoraNetworkServer::GatewayStats &b = m_ns->GetGatewayStats (1);
+  NS_TEST_ASSERT_MSG_EQ (b.m_received, 2, "Wrong copies received by gateway B");
+  NS_TEST_ASSERT_MSG_EQ (b.m_first, 0, "Wrong first copies of gateway B");
+  NS_TEST_ASSERT_MSG_EQ (b.m_selected, 1, "Wrong selections of gateway B");
+  NS_TEST_ASSERT_MSG_EQ (b.m_unique, 0, "Wrong unique uplinks of gateway B");
+
+  m_ns->Dispose ();
+  m_ns = 0;
+  Simulator::Destroy ();
+}
+
+
 class LoraTestAcaSuite : public TestSuite
 {
 public:
@@ -333,6 +1139,15 @@ LoraTestAcaSuite::LoraTestAcaSuite ()
   :  TestSuite ("lora-node", UNIT)
 {
   AddTestCase (new LoraTestAca, TestCase::QUICK);
+  AddTestCase (new LoraTimeOnAirTest, TestCase::QUICK);
+  AddTestCase (new LoraTxModeTableTest, TestCase::QUICK);
+  AddTestCase (new LoraRegionTest, TestCase::QUICK);
+  AddTestCase (new LoraPhyPerTableTest, TestCase::QUICK);
+  AddTestCase (new LoraPhyGenModesTest, TestCase::QUICK);
+  AddTestCase (new LoraPhyDualModesTest, TestCase::QUICK);
+  AddTestCase (new LoraPhyDualDefaultsTest, TestCase::QUICK);
+  AddTestCase (new LoraDemodulatorTest, TestCase::QUICK);
+  AddTestCase (new LoraNetworkServerTest, TestCase::QUICK);
 }
 
 static LoraTestAcaSuite g_LoraTestAcaSuite;
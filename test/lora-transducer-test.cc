@@ -0,0 +1,708 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/lora-transducer-hd.h"
+#include "ns3/lora-net-device.h"
+#include "ns3/lora-channel.h"
+#include "ns3/lora-prop-model-thorp.h"
+#include "ns3/lora-header-common.h"
+#include "ns3/mac-lora-gw.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "ns3/lora-phy-gen.h"
+#include "ns3/lora-phy-dual.h"
+#include "ns3/lora-tx-mode.h"
+#include "ns3/lora-prop-model.h"
+#include "ns3/lora-noise-model.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Arrival list: arrivals of the same packet with different durations
+ * leave the list one by one, and the end of an arrival pending when
+ * the transducer is cleared is ignored.
+ */
+class LoraTransducerArrivalTest : public TestCase
+{
+public:
+  LoraTransducerArrivalTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Record the arrival list of a transducer.
+   *
+   * \param trans The transducer.
+   */
+  void Snapshot (Ptr<LoraTransducerHd> trans);
+
+  std::vector<uint32_t> m_sizes;    //!< Size of the arrival list at each snapshot.
+  std::vector<uint32_t> m_modes;    //!< Mode uid of the first arrival at each snapshot.
+  std::vector<double> m_powers;     //!< Total arrival power at each snapshot.
+};
+
+LoraTransducerArrivalTest::LoraTransducerArrivalTest ()
+  : TestCase ("LoRa transducer arrival list")
+{
+}
+
+void
+LoraTransducerArrivalTest::Snapshot (Ptr<LoraTransducerHd> trans)
+{
+  const LoraTransducer::ArrivalList &arrivals = trans->GetArrivalList ();
+  m_sizes.push_back (arrivals.size ());
+  m_modes.push_back (arrivals.empty () ? 0 : arrivals.front ().GetTxMode ().GetUid ());
+  m_powers.push_back (trans->GetRxPowerKp ());
+}
+
+void
+LoraTransducerArrivalTest::DoRun (void)
+{
+  // Same band, 13 bytes last 0.347 s and 0.173 s.
+  LoraTxMode slow = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10000, 125, 2, "ArrivalTestSlow");
+  LoraTxMode fast = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 600, 120, 10000, 125, 2, "ArrivalTestFast");
+  Ptr<Packet> packet = Create<Packet> (13);
+  LoraPdp pdp = LoraPdp::CreateImpulsePdp ();
+
+  // The same packet, at the same power, arrives in both modes.
+  Ptr<LoraTransducerHd> trans = CreateObject<LoraTransducerHd> ();
+  Simulator::Schedule (Seconds (1), &LoraTransducerHd::Receive, trans, packet, 100.0, slow, pdp);
+  Simulator::Schedule (Seconds (1), &LoraTransducerHd::Receive, trans, packet, 100.0, fast, pdp);
+  Simulator::Schedule (Seconds (1.1), &LoraTransducerArrivalTest::Snapshot, this, trans);
+  Simulator::Schedule (Seconds (1.2), &LoraTransducerArrivalTest::Snapshot, this, trans);
+  Simulator::Schedule (Seconds (1.4), &LoraTransducerArrivalTest::Snapshot, this, trans);
+
+  // Cleared while an arrival is pending.
+  Ptr<LoraTransducerHd> cleared = CreateObject<LoraTransducerHd> ();
+  Simulator::Schedule (Seconds (2), &LoraTransducerHd::Receive, cleared, packet, 100.0, slow, pdp);
+  Simulator::Schedule (Seconds (2.1), &LoraTransducerHd::Clear, cleared);
+  Simulator::Schedule (Seconds (2.2), &LoraTransducerArrivalTest::Snapshot, this, cleared);
+  Simulator::Schedule (Seconds (2.5), &LoraTransducerArrivalTest::Snapshot, this, cleared);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  double kp = std::pow (10, 100 / 10.0);
+  NS_TEST_ASSERT_MSG_EQ (m_sizes.size (), 5, "Missing snapshots");
+  NS_TEST_ASSERT_MSG_EQ (m_sizes[0], 2, "Both arrivals should overlap");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_powers[0], 2 * kp, 1e-6 * kp, "Wrong total power of two arrivals");
+  NS_TEST_ASSERT_MSG_EQ (m_sizes[1], 1, "The shorter arrival should have ended");
+  NS_TEST_ASSERT_MSG_EQ (m_modes[1], slow.GetUid (), "The arrival which ended is not the shorter one");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_powers[1], kp, 1e-6 * kp, "Wrong total power of one arrival");
+  NS_TEST_ASSERT_MSG_EQ (m_sizes[2], 0, "The longer arrival should have ended");
+  NS_TEST_ASSERT_MSG_EQ (m_powers[2], 0, "Power left without arrivals");
+  NS_TEST_ASSERT_MSG_EQ (m_sizes[3], 0, "Arrivals left after Clear");
+  NS_TEST_ASSERT_MSG_EQ (m_sizes[4], 0, "End of a cleared arrival changed the arrival list");
+  NS_TEST_ASSERT_MSG_EQ (m_powers[4], 0, "End of a cleared arrival changed the power");
+}
+
+
+/**
+ * Running interference sums: the SINR computed from the transducer sums
+ * is the one computed from its arrival list, for the Default and Dual
+ * calculators, while random arrivals in overlapping bands come and go.
+ */
+class LoraTransducerSinrTest : public TestCase
+{
+public:
+  LoraTransducerSinrTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Compare both SINR computations for each arrival at a transducer.
+   *
+   * \param trans The transducer.
+   */
+  void Check (Ptr<LoraTransducerHd> trans);
+
+  std::vector<Ptr<LoraPhyCalcSinr> > m_sinr;  //!< Calculators under test.
+  uint32_t m_checks;     //!< Number of SINR comparisons.
+  uint32_t m_overlaps;   //!< Number of checks with interferers.
+};
+
+LoraTransducerSinrTest::LoraTransducerSinrTest ()
+  : TestCase ("LoRa transducer running interference sums"),
+    m_checks (0),
+    m_overlaps (0)
+{
+}
+
+void
+LoraTransducerSinrTest::Check (Ptr<LoraTransducerHd> trans)
+{
+  const LoraTransducer::ArrivalList &arrivals = trans->GetArrivalList ();
+  if (arrivals.size () > 1)
+    {
+      m_overlaps++;
+    }
+  double ambNoiseDb = 50;
+  LoraTransducer::ArrivalList::const_iterator it = arrivals.begin ();
+  for (; it != arrivals.end (); it++)
+    {
+      for (uint32_t s = 0; s < m_sinr.size (); s++)
+        {
+          double fromList = m_sinr[s]->CalcSinrDb (it->GetPacket (), it->GetArrivalTime (), it->GetRxPowerDb (),
+                                                   ambNoiseDb, it->GetTxMode (), it->GetPdp (), arrivals);
+          double fromSums = m_sinr[s]->CalcSinrDbFromTransducer (it->GetPacket (), it->GetArrivalTime (), it->GetRxPowerDb (),
+                                                                 ambNoiseDb, it->GetTxMode (), it->GetPdp (), *trans);
+          NS_TEST_EXPECT_MSG_EQ_TOL (fromSums, fromList, 1e-6,
+                                     "Running sums disagree with the arrival list for calculator " << s
+                                     << " at " << Simulator::Now ().GetSeconds () << "s");
+          m_checks++;
+        }
+    }
+}
+
+void
+LoraTransducerSinrTest::DoRun (void)
+{
+  m_sinr.push_back (CreateObject<LoraPhyCalcSinrDefault> ());
+  m_sinr.push_back (CreateObject<LoraPhyCalcSinrDual> ());
+
+  // Neighboring 125 Hz bands, and a 500 Hz band overlapping them.
+  std::vector<LoraTxMode> modes;
+  modes.push_back (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10000, 125, 2, "SinrTestMode0"));
+  modes.push_back (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10100, 125, 2, "SinrTestMode1"));
+  modes.push_back (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10125, 125, 2, "SinrTestMode2"));
+  modes.push_back (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 1200, 480, 10050, 500, 2, "SinrTestMode3"));
+  LoraPdp pdp = LoraPdp::CreateImpulsePdp ();
+
+  Ptr<LoraTransducerHd> trans = CreateObject<LoraTransducerHd> ();
+  std::minstd_rand rng (1);
+  std::uniform_real_distribution<double> time (0, 10);
+  std::uniform_real_distribution<double> power (60, 120);
+  std::uniform_int_distribution<uint32_t> mode (0, modes.size () - 1);
+  std::uniform_int_distribution<uint32_t> size (5, 40);
+  for (uint32_t k = 0; k < 200; k++)
+    {
+      Simulator::Schedule (Seconds (time (rng)), &LoraTransducerHd::Receive, trans,
+                           Create<Packet> (size (rng)), power (rng), modes[mode (rng)], pdp);
+    }
+  for (uint32_t k = 0; k < 250; k++)
+    {
+      Simulator::Schedule (Seconds (0.05 * k), &LoraTransducerSinrTest::Check, this, trans);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_GT (m_overlaps, 100, "Too few overlapping arrivals");
+  NS_TEST_ASSERT_MSG_GT (m_checks, 1000, "Too few comparisons");
+  m_sinr.clear ();
+}
+
+
+/**
+ * Band power queries: the power overlapping a band is that of the
+ * arrival list, after a band emptied in the middle of the band arrays
+ * is replaced by the last one, and after each arrival event drops the
+ * results kept for the previous one.
+ */
+class LoraTransducerBandPowerTest : public TestCase
+{
+public:
+  LoraTransducerBandPowerTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Compare the band powers of a transducer with a sum over its
+   * arrival list, for each query band.
+   *
+   * \param trans The transducer.
+   */
+  void Check (Ptr<LoraTransducerHd> trans);
+
+  std::vector<LoraTxMode> m_queries;  //!< Bands queried.
+  std::vector<double> m_firstKp;      //!< Power in the first query band at each check.
+};
+
+LoraTransducerBandPowerTest::LoraTransducerBandPowerTest ()
+  : TestCase ("LoRa transducer band power queries")
+{
+}
+
+void
+LoraTransducerBandPowerTest::Check (Ptr<LoraTransducerHd> trans)
+{
+  const LoraTransducer::ArrivalList &arrivals = trans->GetArrivalList ();
+  for (uint32_t q = 0; q < m_queries.size (); q++)
+    {
+      uint32_t cfHz = m_queries[q].GetCenterFreqHz ();
+      uint32_t bwHz = m_queries[q].GetBandwidthHz ();
+      double expected = 0;
+      LoraTransducer::ArrivalList::const_iterator it = arrivals.begin ();
+      for (; it != arrivals.end (); it++)
+        {
+          double dist = std::abs ((double) it->GetTxMode ().GetCenterFreqHz () - cfHz);
+          if (dist < (double)(it->GetTxMode ().GetBandwidthHz () / 2) + (double)(bwHz / 2) - 0.5)
+            {
+              expected += std::pow (10, it->GetRxPowerDb () / 10.0);
+            }
+        }
+      double kp = trans->GetBandRxPowerKp (cfHz, bwHz);
+      NS_TEST_EXPECT_MSG_EQ_TOL (kp, expected, 1e-9 * expected,
+                                 "Wrong power in band " << q << " at " << Simulator::Now ().GetSeconds () << "s");
+      NS_TEST_EXPECT_MSG_EQ (trans->GetBandRxPowerKp (cfHz, bwHz), kp, "Repeated query of band " << q << " changed");
+      if (q == 0)
+        {
+          m_firstKp.push_back (kp);
+        }
+    }
+}
+
+void
+LoraTransducerBandPowerTest::DoRun (void)
+{
+  // 13 bytes last 0.347 s in each mode.
+  LoraTxMode a = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10000, 125, 2, "BandTestA");
+  LoraTxMode b = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10100, 125, 2, "BandTestB");
+  LoraTxMode c = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10300, 125, 2, "BandTestC");
+  LoraTxMode d = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10050, 500, 2, "BandTestD");
+  m_queries.push_back (a);
+  m_queries.push_back (b);
+  m_queries.push_back (c);
+  m_queries.push_back (d);
+  m_queries.push_back (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10200, 125, 2, "BandTestQuery"));
+  m_queries.push_back (LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 20000, 125, 2, "BandTestFar"));
+  LoraPdp pdp = LoraPdp::CreateImpulsePdp ();
+
+  Ptr<LoraTransducerHd> trans = CreateObject<LoraTransducerHd> ();
+  Simulator::Schedule (Seconds (1), &LoraTransducerHd::Receive, trans, Create<Packet> (13), 100.0, a, pdp);
+  Simulator::Schedule (Seconds (1.01), &LoraTransducerHd::Receive, trans, Create<Packet> (13), 90.0, b, pdp);
+  Simulator::Schedule (Seconds (1.02), &LoraTransducerHd::Receive, trans, Create<Packet> (13), 80.0, c, pdp);
+  Simulator::Schedule (Seconds (1.03), &LoraTransducerHd::Receive, trans, Create<Packet> (13), 70.0, d, pdp);
+  // Band a, the first of the arrays, empties at 1.347 s with three bands
+  // left, then gets an arrival again, at the end of the arrays.
+  Simulator::Schedule (Seconds (1.355), &LoraTransducerHd::Receive, trans, Create<Packet> (13), 95.0, a, pdp);
+  Simulator::Schedule (Seconds (1.356), &LoraTransducerHd::Receive, trans, Create<Packet> (13), 85.0, c, pdp);
+
+  double times[] = { 0.5, 1.005, 1.1, 1.35, 1.3555, 1.36, 1.368, 1.4, 2.0 };
+  for (uint32_t k = 0; k < sizeof (times) / sizeof (times[0]); k++)
+    {
+      Simulator::Schedule (Seconds (times[k]), &LoraTransducerBandPowerTest::Check, this, trans);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  double kp100 = std::pow (10, 100 / 10.0);
+  double kp95 = std::pow (10, 95 / 10.0);
+  double kp90 = std::pow (10, 90 / 10.0);
+  double kp70 = std::pow (10, 70 / 10.0);
+  NS_TEST_ASSERT_MSG_EQ (m_firstKp.size (), 9, "Missing checks");
+  NS_TEST_ASSERT_MSG_EQ (m_firstKp[0], 0, "Power before any arrival");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_firstKp[1], kp100, 1e-9 * kp100, "Wrong power of one arrival");
+  // Bands b and d overlap band a, band c does not.
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_firstKp[2], kp100 + kp90 + kp70, 1e-9 * kp100, "Wrong power of overlapping arrivals");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_firstKp[3], kp90 + kp70, 1e-9 * kp90, "Power of an ended arrival kept");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_firstKp[4], kp95 + kp90 + kp70, 1e-9 * kp95, "Arrival in a refilled band missed");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_firstKp[5], kp95 + kp70, 1e-9 * kp95, "Power of an ended arrival kept");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_firstKp[7], kp95, 1e-9 * kp95, "Power of an ended arrival kept");
+  NS_TEST_ASSERT_MSG_EQ (m_firstKp[8], 0, "Power left without arrivals");
+  m_queries.clear ();
+}
+
+/**
+ * Noise model with a flat noise level, counting its evaluations.
+ */
+class LoraCountingNoiseModel : public LoraNoiseModel
+{
+public:
+  LoraCountingNoiseModel ()
+    : m_levelDbHz (0),
+      m_calls (0)
+  {
+  }
+  virtual double GetNoiseDbHz (double fKhz) const
+  {
+    m_calls++;
+    return m_levelDbHz;
+  }
+
+  double m_levelDbHz;        //!< Noise level, in dB/Hz.
+  mutable uint32_t m_calls;  //!< Number of evaluations.
+};
+
+/**
+ * Noise figures: each transducer evaluates the channel noise model
+ * once per mode, for all its PHYs, and evaluates it again after the
+ * channel or its noise model changes.
+ */
+class LoraTransducerNoiseTest : public TestCase
+{
+public:
+  LoraTransducerNoiseTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Create a noise model.
+   *
+   * \param levelDbHz The noise level, in dB/Hz.
+   * \return The noise model.
+   */
+  Ptr<LoraCountingNoiseModel> CreateNoise (double levelDbHz);
+};
+
+LoraTransducerNoiseTest::LoraTransducerNoiseTest ()
+  : TestCase ("LoRa transducer noise figures")
+{
+}
+
+Ptr<LoraCountingNoiseModel>
+LoraTransducerNoiseTest::CreateNoise (double levelDbHz)
+{
+  Ptr<LoraCountingNoiseModel> noise = CreateObject<LoraCountingNoiseModel> ();
+  noise->m_levelDbHz = levelDbHz;
+  return noise;
+}
+
+void
+LoraTransducerNoiseTest::DoRun (void)
+{
+  LoraTxMode narrow = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10000, 125, 2, "NoiseTestNarrow");
+  LoraTxMode wide = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 1200, 480, 10000, 500, 2, "NoiseTestWide");
+  double narrowDb = 10 * std::log10 (125.0);
+  double wideDb = 10 * std::log10 (500.0);
+
+  Ptr<LoraCountingNoiseModel> first = CreateNoise (50);
+  Ptr<LoraChannel> chan = CreateObject<LoraChannel> ();
+  chan->SetNoiseModel (first);
+  Ptr<LoraTransducerHd> trans = CreateObject<LoraTransducerHd> ();
+  Ptr<LoraTransducerHd> other = CreateObject<LoraTransducerHd> ();
+  trans->SetChannel (chan);
+  other->SetChannel (chan);
+  chan->AddDevice (CreateObject<LoraNetDevice> (), trans);
+  chan->AddDevice (CreateObject<LoraNetDevice> (), other);
+
+  // Repeated lookups, as from sibling PHYs, reuse the first evaluation.
+  NS_TEST_ASSERT_MSG_EQ_TOL (trans->GetNoiseDb (narrow), 50 + narrowDb, 1e-9, "Wrong narrow band noise");
+  NS_TEST_ASSERT_MSG_EQ_TOL (trans->GetNoiseDb (narrow), 50 + narrowDb, 1e-9, "Wrong cached narrow band noise");
+  NS_TEST_ASSERT_MSG_EQ (first->m_calls, 1, "Noise of a mode evaluated twice");
+  NS_TEST_ASSERT_MSG_EQ_TOL (trans->GetNoiseDb (wide), 50 + wideDb, 1e-9, "Wrong wide band noise");
+  NS_TEST_ASSERT_MSG_EQ_TOL (trans->GetNoiseDb (wide), 50 + wideDb, 1e-9, "Wrong cached wide band noise");
+  NS_TEST_ASSERT_MSG_EQ (first->m_calls, 2, "Noise not evaluated once per mode");
+  NS_TEST_ASSERT_MSG_EQ_TOL (other->GetNoiseDb (narrow), 50 + narrowDb, 1e-9, "Wrong noise at another transducer");
+  NS_TEST_ASSERT_MSG_EQ (first->m_calls, 3, "Noise not evaluated once per transducer");
+
+  // A new noise model reaches every attached transducer.
+  Ptr<LoraCountingNoiseModel> second = CreateNoise (60);
+  chan->SetNoiseModel (second);
+  NS_TEST_ASSERT_MSG_EQ_TOL (trans->GetNoiseDb (narrow), 60 + narrowDb, 1e-9, "Noise of the replaced model kept");
+  NS_TEST_ASSERT_MSG_EQ_TOL (trans->GetNoiseDb (wide), 60 + wideDb, 1e-9, "Noise of the replaced model kept");
+  NS_TEST_ASSERT_MSG_EQ_TOL (other->GetNoiseDb (narrow), 60 + narrowDb, 1e-9, "Noise of the replaced model kept at another transducer");
+  NS_TEST_ASSERT_MSG_EQ (first->m_calls, 3, "Replaced noise model evaluated");
+  NS_TEST_ASSERT_MSG_EQ (second->m_calls, 3, "Wrong number of evaluations of the new noise model");
+
+  // Likewise through the attribute.
+  Ptr<LoraCountingNoiseModel> third = CreateNoise (70);
+  chan->SetAttribute ("NoiseModel", PointerValue (third));
+  NS_TEST_ASSERT_MSG_EQ_TOL (trans->GetNoiseDb (narrow), 70 + narrowDb, 1e-9, "Noise model attribute change missed");
+  NS_TEST_ASSERT_MSG_EQ (third->m_calls, 1, "Wrong number of evaluations after the attribute change");
+
+  // Moving a transducer to another channel uses the noise of that channel.
+  Ptr<LoraChannel> chan2 = CreateObject<LoraChannel> ();
+  chan2->SetNoiseModel (CreateNoise (80));
+  trans->SetChannel (chan2);
+  NS_TEST_ASSERT_MSG_EQ_TOL (trans->GetNoiseDb (narrow), 80 + narrowDb, 1e-9, "Noise of the previous channel kept");
+  NS_TEST_ASSERT_MSG_EQ_TOL (other->GetNoiseDb (narrow), 70 + narrowDb, 1e-9, "Channel change of another transducer reset this one");
+
+  chan->Dispose ();
+  chan2->Dispose ();
+}
+
+/**
+ * Transmissions and receptions through the transducer: counts and times
+ * of the RX ok, RX error and TX end traces are those of the model with
+ * separate end of TX events, with overlapping transmissions from a dual
+ * PHY, and nothing reaches the PHYs of a cleared transducer.
+ */
+class LoraTransducerTxRxTest : public TestCase
+{
+public:
+  LoraTransducerTxRxTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Create a device on its own node.
+   *
+   * \param chan The channel.
+   * \param pos Position of the node.
+   * \param phy The PHY of the device.
+   * \return The device.
+   */
+  static Ptr<LoraNetDevice> CreateDevice (Ptr<LoraChannel> chan, Vector pos, Ptr<LoraPhy> phy);
+  /**
+   * Create a device with a LoraPhyGen supporting a single mode.
+   *
+   * \param chan The channel.
+   * \param pos Position of the node.
+   * \param mode The mode.
+   * \return The device.
+   */
+  static Ptr<LoraNetDevice> CreateDevice (Ptr<LoraChannel> chan, Vector pos, LoraTxMode mode);
+  /**
+   * Broadcast a packet.
+   *
+   * \param dev The sending device.
+   * \param size Size of the packet.
+   * \param mode Mode number.
+   */
+  static void Send (Ptr<LoraNetDevice> dev, uint32_t size, uint32_t mode);
+  /**
+   * Connect the traces of a PHY.
+   *
+   * \param phy The PHY.
+   * \param name Name of the PHY in the log.
+   */
+  void Trace (Ptr<LoraPhy> phy, std::string name);
+  /**
+   * Log a PHY TX or RX trace.
+   *
+   * \param context Name of the PHY and of the trace.
+   * \param packet The packet.
+   */
+  void Log (std::string context, Ptr<const Packet> packet);
+  /**
+   * Log an RX ok or RX error trace.
+   *
+   * \param context Name of the PHY and of the trace.
+   * \param packet The packet.
+   * \param sinr The SINR.
+   * \param mode The mode.
+   */
+  void LogRx (std::string context, Ptr<const Packet> packet, double sinr, LoraTxMode mode);
+  /**
+   * Record the state of a transducer.
+   *
+   * \param trans The transducer.
+   */
+  void LogState (Ptr<LoraTransducer> trans);
+
+  std::map<std::string, std::vector<Time> > m_times;      //!< Times of each trace.
+  std::map<std::string, std::vector<uint32_t> > m_sizes;  //!< Packet sizes of each trace.
+  std::vector<bool> m_tx;                                 //!< Recorded transducer states, true in TX.
+};
+
+LoraTransducerTxRxTest::LoraTransducerTxRxTest ()
+  : TestCase ("LoRa transducer TX and RX events")
+{
+}
+
+Ptr<LoraNetDevice>
+LoraTransducerTxRxTest::CreateDevice (Ptr<LoraChannel> chan, Vector pos, Ptr<LoraPhy> phy)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<LoraNetDevice> dev = CreateObject<LoraNetDevice> ();
+  Ptr<MacLoraAca> mac = CreateObject<MacLoraAca> ();
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (LoraAddress::Allocate ());
+
+  dev->SetPhy (phy);
+  dev->SetMac (mac);
+  dev->SetChannel (chan);
+  dev->SetTransducer (CreateObject<LoraTransducerHd> ());
+  node->AddDevice (dev);
+  return dev;
+}
+
+Ptr<LoraNetDevice>
+LoraTransducerTxRxTest::CreateDevice (Ptr<LoraChannel> chan, Vector pos, LoraTxMode mode)
+{
+  LoraModesList modes;
+  modes.AppendMode (mode);
+  Ptr<LoraPhyGen> phy = CreateObject<LoraPhyGen> ();
+  phy->SetAttribute ("SupportedModes", LoraModesListValue (modes));
+  return CreateDevice (chan, pos, phy);
+}
+
+void
+LoraTransducerTxRxTest::Send (Ptr<LoraNetDevice> dev, uint32_t size, uint32_t mode)
+{
+  dev->Send (Create<Packet> (size), dev->GetBroadcast (), mode);
+}
+
+void
+LoraTransducerTxRxTest::Trace (Ptr<LoraPhy> phy, std::string name)
+{
+  const char *traces[] = { "PhyTxBegin", "PhyTxEnd", "PhyTxDrop" };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      phy->TraceConnect (traces[i], name + " " + traces[i], MakeCallback (&LoraTransducerTxRxTest::Log, this));
+    }
+  phy->TraceConnect ("RxOk", name + " RxOk", MakeCallback (&LoraTransducerTxRxTest::LogRx, this));
+  phy->TraceConnect ("RxError", name + " RxError", MakeCallback (&LoraTransducerTxRxTest::LogRx, this));
+}
+
+void
+LoraTransducerTxRxTest::Log (std::string context, Ptr<const Packet> packet)
+{
+  m_times[context].push_back (Simulator::Now ());
+  m_sizes[context].push_back (packet->GetSize ());
+}
+
+void
+LoraTransducerTxRxTest::LogRx (std::string context, Ptr<const Packet> packet, double sinr, LoraTxMode mode)
+{
+  Log (context, packet);
+}
+
+void
+LoraTransducerTxRxTest::LogState (Ptr<LoraTransducer> trans)
+{
+  m_tx.push_back (trans->IsTx ());
+}
+
+void
+LoraTransducerTxRxTest::DoRun (void)
+{
+  LoraTxMode slow = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 300, 120, 10000, 125, 2, "TxRxTestSlow");
+  LoraTxMode fast = LoraTxModeFactory::CreateMode (LoraTxMode::LORA, 600, 240, 12000, 125, 2, "TxRxTestFast");
+
+  // A single link at 1s, then a collision at B at 3s.
+  Ptr<LoraChannel> channel = CreateObject<LoraChannel> ();
+  channel->SetAttribute ("PropagationModel", PointerValue (CreateObject<LoraPropModelThorp> ()));
+  Ptr<LoraNetDevice> a = CreateDevice (channel, Vector (0, 0, 0), slow);
+  Ptr<LoraNetDevice> b = CreateDevice (channel, Vector (100, 0, 0), slow);
+  Ptr<LoraNetDevice> c = CreateDevice (channel, Vector (200, 0, 0), slow);
+  Trace (a->GetPhy (), "A");
+  Trace (b->GetPhy (), "B");
+  Trace (c->GetPhy (), "C");
+  Simulator::Schedule (Seconds (1), &LoraTransducerTxRxTest::Send, a, 13, 0);
+  Simulator::Schedule (Seconds (3), &LoraTransducerTxRxTest::Send, a, 13, 0);
+  Simulator::Schedule (Seconds (3), &LoraTransducerTxRxTest::Send, c, 13, 0);
+
+  // Overlapping transmissions from the sub-PHYs of a dual PHY, the
+  // second one ending first at 5s, last at 7s.
+  Ptr<LoraChannel> dualChannel = CreateObject<LoraChannel> ();
+  Ptr<LoraPhyDual> dual = CreateObject<LoraPhyDual> ();
+  LoraModesList slowModes;
+  slowModes.AppendMode (slow);
+  LoraModesList fastModes;
+  fastModes.AppendMode (fast);
+  dual->SetModesPhy (0, slowModes);
+  dual->SetModesPhy (1, fastModes);
+  Ptr<LoraNetDevice> d = CreateDevice (dualChannel, Vector (0, 0, 0), dual);
+  Trace (dual->GetPhy (0), "D0");
+  Trace (dual->GetPhy (1), "D1");
+  Simulator::Schedule (Seconds (5), &LoraTransducerTxRxTest::Send, d, 13, 0);
+  Simulator::Schedule (Seconds (5.1), &LoraTransducerTxRxTest::Send, d, 5, 1);
+  Simulator::Schedule (Seconds (7), &LoraTransducerTxRxTest::Send, d, 13, 0);
+  Simulator::Schedule (Seconds (7.1), &LoraTransducerTxRxTest::Send, d, 60, 1);
+
+  // Transducers cleared while F transmits and G receives.
+  Ptr<LoraChannel> clearedChannel = CreateObject<LoraChannel> ();
+  clearedChannel->SetAttribute ("PropagationModel", PointerValue (CreateObject<LoraPropModelThorp> ()));
+  Ptr<LoraNetDevice> f = CreateDevice (clearedChannel, Vector (0, 0, 0), slow);
+  Ptr<LoraNetDevice> g = CreateDevice (clearedChannel, Vector (100, 0, 0), slow);
+  Trace (f->GetPhy (), "F");
+  Trace (g->GetPhy (), "G");
+  Simulator::Schedule (Seconds (9), &LoraTransducerTxRxTest::Send, f, 13, 0);
+  Simulator::Schedule (Seconds (9.2), &LoraTransducer::Clear, g->GetTransducer ());
+
+  // Transducer states around the ends of the overlapping transmissions.
+  uint32_t header = LoraHeaderCommon ().GetSerializedSize ();
+  Time toa0 = slow.GetTimeOnAir (13 + header);
+  Time longToa1 = fast.GetTimeOnAir (60 + header);
+  Simulator::Schedule (Seconds (5) + toa0 - MilliSeconds (10), &LoraTransducerTxRxTest::LogState, this, d->GetTransducer ());
+  Simulator::Schedule (Seconds (5) + toa0 + MilliSeconds (10), &LoraTransducerTxRxTest::LogState, this, d->GetTransducer ());
+  Simulator::Schedule (Seconds (7) + toa0 + MilliSeconds (10), &LoraTransducerTxRxTest::LogState, this, d->GetTransducer ());
+  Simulator::Schedule (Seconds (7.1) + longToa1 + MilliSeconds (10), &LoraTransducerTxRxTest::LogState, this, d->GetTransducer ());
+
+  Simulator::Stop (Seconds (15));
+  Simulator::Run ();
+
+  // Single link: A ends its transmission, B and C decode.
+  NS_TEST_ASSERT_MSG_EQ (m_sizes["A PhyTxBegin"].size (), 2, "Wrong number of transmissions of A");
+  uint32_t size = m_sizes["A PhyTxBegin"][0];
+  Time toa = slow.GetTimeOnAir (size);
+  NS_TEST_ASSERT_MSG_EQ (m_times["A PhyTxEnd"].size (), 2, "Wrong number of TX ends of A");
+  NS_TEST_ASSERT_MSG_EQ (m_times["A PhyTxEnd"][0], Seconds (1) + toa, "Wrong TX end time of A");
+  NS_TEST_ASSERT_MSG_EQ (m_times["A PhyTxEnd"][1], Seconds (3) + toa, "Wrong TX end time of A");
+  NS_TEST_ASSERT_MSG_EQ (m_times["C PhyTxEnd"].size (), 1, "Wrong number of TX ends of C");
+  NS_TEST_ASSERT_MSG_EQ (m_times["C PhyTxEnd"][0], Seconds (3) + toa, "Wrong TX end time of C");
+  NS_TEST_ASSERT_MSG_EQ (m_times["B RxOk"].size (), 1, "Wrong number of receptions of B");
+  NS_TEST_ASSERT_MSG_EQ (m_times["B RxOk"][0], Seconds (1) + Seconds (100 / 1500.0) + toa, "Wrong RX end time of B");
+  NS_TEST_ASSERT_MSG_EQ (m_times["C RxOk"].size (), 1, "Wrong number of receptions of C");
+  NS_TEST_ASSERT_MSG_EQ (m_times["C RxOk"][0], Seconds (1) + Seconds (200 / 1500.0) + toa, "Wrong RX end time of C");
+  // Collision: B loses the frame it started receiving.
+  NS_TEST_ASSERT_MSG_EQ (m_times["B RxError"].size (), 1, "Wrong number of receptions in error of B");
+  NS_TEST_ASSERT_MSG_EQ (m_times["B RxError"][0], Seconds (3) + Seconds (100 / 1500.0) + toa, "Wrong RX error time of B");
+  NS_TEST_ASSERT_MSG_EQ (m_times["A RxOk"].size () + m_times["A RxError"].size (), 0, "A received while transmitting");
+
+  // Overlapping transmissions: the second one is reported dropped, and
+  // its end comes no earlier than the end of the first one.
+  NS_TEST_ASSERT_MSG_EQ (m_times["D0 PhyTxBegin"].size (), 2, "Wrong number of transmissions of D0");
+  NS_TEST_ASSERT_MSG_EQ (m_times["D1 PhyTxBegin"].size (), 0, "D1 began a transmission during one of D0");
+  NS_TEST_ASSERT_MSG_EQ (m_times["D1 PhyTxDrop"].size (), 2, "Wrong number of overlapping transmissions of D1");
+  NS_TEST_ASSERT_MSG_EQ (m_times["D0 PhyTxEnd"].size (), 2, "Wrong number of TX ends of D0");
+  NS_TEST_ASSERT_MSG_EQ (m_times["D1 PhyTxEnd"].size (), 2, "Wrong number of TX ends of D1");
+  NS_TEST_ASSERT_MSG_EQ (m_sizes["D0 PhyTxBegin"][0], 13 + header, "Wrong frame size of D0");
+  NS_TEST_ASSERT_MSG_EQ (m_sizes["D1 PhyTxDrop"][1], 60 + header, "Wrong frame size of D1");
+  Time shortToa1 = fast.GetTimeOnAir (m_sizes["D1 PhyTxDrop"][0]);
+  NS_TEST_ASSERT_MSG_LT (Seconds (5.1) + shortToa1, Seconds (5) + toa0, "Second transmission should end first");
+  NS_TEST_ASSERT_MSG_GT (Seconds (7.1) + longToa1, Seconds (7) + toa0, "Second transmission should end last");
+  NS_TEST_ASSERT_MSG_EQ (m_times["D0 PhyTxEnd"][0], Seconds (5) + toa0, "Wrong TX end time of D0");
+  NS_TEST_ASSERT_MSG_EQ (m_times["D1 PhyTxEnd"][0], Seconds (5) + toa0, "TX end of D1 not pushed to the end of D0");
+  NS_TEST_ASSERT_MSG_EQ (m_times["D0 PhyTxEnd"][1], Seconds (7) + toa0, "Wrong TX end time of D0");
+  NS_TEST_ASSERT_MSG_EQ (m_times["D1 PhyTxEnd"][1], Seconds (7.1) + longToa1, "Wrong TX end time of D1");
+  NS_TEST_ASSERT_MSG_EQ (m_tx.size (), 4, "Missing transducer states");
+  NS_TEST_ASSERT_MSG_EQ (m_tx[0], true, "Transducer left TX before the end of the first transmission");
+  NS_TEST_ASSERT_MSG_EQ (m_tx[1], false, "Transducer still in TX after both transmissions");
+  NS_TEST_ASSERT_MSG_EQ (m_tx[2], true, "Transducer left TX before the end of the second transmission");
+  NS_TEST_ASSERT_MSG_EQ (m_tx[3], false, "Transducer still in TX after both transmissions");
+
+  // Clear: neither the pending end of TX nor the pending arrival reach
+  // the PHYs.
+  NS_TEST_ASSERT_MSG_EQ (m_times["F PhyTxBegin"].size (), 1, "Wrong number of transmissions of F");
+  NS_TEST_ASSERT_MSG_EQ (m_times["F PhyTxEnd"].size (), 0, "End of TX reported after Clear");
+  NS_TEST_ASSERT_MSG_EQ (m_times["G RxOk"].size () + m_times["G RxError"].size (), 0, "Reception reported after Clear");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * LoRa transducer test suite.
+ */
+class LoraTransducerTestSuite : public TestSuite
+{
+public:
+  LoraTransducerTestSuite ();
+};
+
+LoraTransducerTestSuite::LoraTransducerTestSuite ()
+  : TestSuite ("lora-transducer", UNIT)
+{
+  AddTestCase (new LoraTransducerArrivalTest, TestCase::QUICK);
+  AddTestCase (new LoraTransducerSinrTest, TestCase::QUICK);
+  AddTestCase (new LoraTransducerBandPowerTest, TestCase::QUICK);
+  AddTestCase (new LoraTransducerNoiseTest, TestCase::QUICK);
+  AddTestCase (new LoraTransducerTxRxTest, TestCase::QUICK);
+}
+
+static LoraTransducerTestSuite g_loraTransducerTestSuite;